@@ -25,6 +25,11 @@
 
                 "src/shaders.cpp",
                 "src/renderer.cpp",
+                "src/hittest.cpp",
+                "src/textcache.cpp",
+                "src/timeline.cpp",
+                "src/animset.cpp",
+                "src/easing.cpp",
                 "src/mathutils.cpp"
             ],
             "include_dirs": [
@@ -0,0 +1,64 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+const timeFuncs = [ 'linear', 'cubicIn', 'cubicOut', 'cubicInOut' ];
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    const count = 10000;
+    const w = this.w();
+    const h = this.h();
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //animated nodes
+    const nodes = [];
+
+    const anims = [];
+
+    function startAnim(rect, i) {
+        return rect.x.anim().from(0).to(w - 4).dur(1000 + Math.random() * 4000).timeFunc(timeFuncs[i % timeFuncs.length]).loop(-1).autoreverse(true).start();
+    }
+
+    for (let i = 0; i < count; i++) {
+        const rect = this.createRect().y(Math.random() * h).w(4).h(4).fill('#00FF00');
+
+        anims.push(startAnim(rect, i));
+        nodes.push(rect);
+    }
+
+    g.setChildren(nodes);
+
+    //restart 1000 animations per second while rendering
+    setInterval(() => {
+        const startTime = Date.now();
+
+        for (let i = 0; i < 1000; i++) {
+            const index = Math.floor(Math.random() * count);
+
+            anims[index].stop();
+            anims[index] = startAnim(nodes[index], index);
+        }
+
+        console.log('restarted 1000 animations in ' + (Date.now() - startTime) + ' ms');
+    }, 1000);
+
+    //animation time per frame
+    setInterval(() => {
+        const stats = gfx.getStats();
+        let line = 'animations: ' + stats.animations + ', processAnimations(): ' + stats.animationTime.toFixed(3) + ' ms';
+
+        if (stats.fps) {
+            line += ', fps: ' + stats.fps.fps.toFixed(1);
+        }
+
+        console.log(line);
+    }, 1000);
+});
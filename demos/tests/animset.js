@@ -0,0 +1,45 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    const group = this.createGroup();
+
+    this.setRoot(group);
+
+    //200 list items
+    const count = 200;
+    const xs = [];
+    const opacities = [];
+
+    for (let i = 0; i < count; i++) {
+        const rect = this.createRect().w(20).h(20).x(-20).y(i % 20 * 25).opacity(0).fill('#00FF00');
+
+        group.add(rect);
+
+        xs.push(rect.x);
+        opacities.push(rect.opacity);
+    }
+
+    //staggered entrance: 400 targets, one native object
+    const start = Date.now();
+
+    this.createAnimSet()
+        .from(0).to(1).dur(500).timeFunc('ease-out')
+        .addAll(xs, { stagger: 10, scale: 300, offset: -20 })
+        .addAll(opacities, { stagger: 10 })
+        .then(() => {
+            console.log('done after ' + (Date.now() - start) + ' ms');
+            console.log(gfx.getStats());
+        })
+        .start();
+});
@@ -0,0 +1,78 @@
+'use strict';
+
+const amino = require('../../main.js');
+const os = require('os');
+const path = require('path');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    const count = 10000;
+    const w = this.w();
+    const h = this.h();
+
+    //description
+    const desc = {
+        type: 'group',
+        id: 'root',
+        children: []
+    };
+
+    const attrs = [];
+
+    for (let i = 0; i < count; i++) {
+        const item = {
+            x: Math.random() * w,
+            y: Math.random() * h,
+            w: 10,
+            h: 10,
+            fill: '#FF0000'
+        };
+
+        attrs.push(item);
+        desc.children.push(Object.assign({ type: 'rect' }, item));
+    }
+
+    // 1) native
+    let startTime = Date.now();
+    const root = this.buildScene(desc);
+
+    console.log('buildScene(): ' + count + ' nodes in ' + (Date.now() - startTime) + ' ms');
+
+    //JSON string (parsed first)
+    const json = JSON.stringify(desc);
+
+    startTime = Date.now();
+    this.buildScene(json);
+
+    console.log('buildScene(json): ' + count + ' nodes in ' + (Date.now() - startTime) + ' ms');
+
+    // 2) JS
+    startTime = Date.now();
+
+    const g = this.createGroup();
+
+    for (let i = 0; i < count; i++) {
+        g.add(this.createRect(attrs[i]));
+    }
+
+    console.log('createRect(): ' + count + ' nodes in ' + (Date.now() - startTime) + ' ms');
+
+    // 3) snapshot
+    const file = path.join(os.tmpdir(), 'amino-scene.bin');
+
+    startTime = Date.now();
+    this.saveScene(root, file);
+    console.log('saveScene(): ' + (Date.now() - startTime) + ' ms');
+
+    startTime = Date.now();
+    this.loadScene(file);
+    console.log('loadScene(): ' + count + ' nodes in ' + (Date.now() - startTime) + ' ms');
+
+    this.setRoot(root);
+});
@@ -0,0 +1,22 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+//memory before loading
+const external = process.memoryUsage().external;
+
+amino.fonts.getFont({
+    name: 'noto-ui',
+    size: 20
+}, (err, font) => {
+    if (err) {
+        console.log('could not load font: ' + err.message);
+        return;
+    }
+
+    //Note: font file is memory-mapped (not in the JS heap)
+    const diff = process.memoryUsage().external - external;
+
+    console.log('external memory: ' + (diff / 1024).toFixed(1) + ' KB');
+    console.log('fonts: ' + JSON.stringify(amino.fonts.getStats()));
+});
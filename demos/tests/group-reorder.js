@@ -0,0 +1,64 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    const count = 10000;
+    const w = this.w();
+    const h = this.h();
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //children
+    const nodes = [];
+
+    for (let i = 0; i < count; i++) {
+        nodes.push(this.createRect().x(Math.random() * w).y(Math.random() * h).w(10).h(10).fill('#00FF00'));
+    }
+
+    let startTime = Date.now();
+
+    g.setChildren(nodes);
+    console.log('setChildren(): ' + count + ' nodes in ' + (Date.now() - startTime) + ' ms');
+
+    // 1) reorder (reverse)
+    const perm = [];
+
+    for (let i = 0; i < count; i++) {
+        perm.push(count - i - 1);
+    }
+
+    startTime = Date.now();
+    g.reorder(perm);
+    console.log('reorder(): ' + (Date.now() - startTime) + ' ms');
+
+    // 2) sort by position
+    startTime = Date.now();
+    g.sort((a, b) => a.y() - b.y());
+    console.log('sort(): ' + (Date.now() - startTime) + ' ms');
+
+    // 3) reorder with remove() & add()
+    startTime = Date.now();
+
+    const children = g.children.slice();
+
+    for (let i = children.length - 1; i >= 0; i--) {
+        g.remove(children[i]);
+        g.add(children[i]);
+    }
+
+    console.log('remove()/add(): ' + (Date.now() - startTime) + ' ms');
+
+    // 4) clear
+    startTime = Date.now();
+    g.clear();
+    console.log('clear(): ' + (Date.now() - startTime) + ' ms');
+});
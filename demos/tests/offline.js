@@ -0,0 +1,49 @@
+'use strict';
+
+const amino = require('../../main.js');
+const fs = require('fs');
+const path = require('path');
+
+//render 2 seconds at 30 fps as fast as possible (raw RGBA frames, bottom-up)
+const fps = 30;
+const frames = fps * 2;
+const outFile = path.join(__dirname, 'offline.rgba');
+const out = fs.openSync(outFile, 'w');
+const startTime = Date.now();
+
+const gfx = new amino.AminoGfx({
+    offline: {
+        fps: fps,
+        frame: (pixels, info) => {
+            fs.writeSync(out, pixels);
+
+            if (info.frame + 1 === frames) {
+                const diff = Date.now() - startTime;
+
+                console.log('rendered ' + frames + ' frames (' + info.w + 'x' + info.h + ') in ' + diff + ' ms');
+                console.log('ffmpeg -f rawvideo -pix_fmt rgba -s ' + info.w + 'x' + info.h + ' -r ' + fps + ' -i ' + outFile + ' -vf vflip out.mp4');
+
+                fs.closeSync(out);
+                gfx.destroy();
+            }
+        }
+    }
+});
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    const group = this.createGroup();
+    const rect = this.createRect().w(50).h(50).fill('#FF0000');
+
+    group.add(rect);
+    this.setRoot(group);
+
+    //exactly one pixel per frame
+    rect.x.anim().from(0).to(frames).dur(frames * 1000 / fps).timeFunc('linear').start();
+});
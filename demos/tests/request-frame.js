@@ -0,0 +1,48 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    //create group
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //native animation
+    const r1 = this.createRect().x(0).y(0).w(100).h(100).fill('#FF0000');
+
+    r1.x.anim().from(0).to(500).dur(2000).autoreverse(true).loop(-1).start();
+    g.add(r1);
+
+    //frame callback animation (follows the native one)
+    const r2 = this.createRect().x(0).y(150).w(100).h(100).fill('#00FF00');
+    let frames = 0;
+    let lastTime = 0;
+
+    g.add(r2);
+
+    const frame = (time) => {
+        frames++;
+
+        //r1.x() is already updated to this frame
+        r2.x(r1.x());
+
+        if (lastTime && frames % 60 === 0) {
+            console.log('frame: ' + frames + ', delta: ' + (time - lastTime).toFixed(3) + ' ms, skipped signals: ' + gfx.getStats().skippedSignals);
+        }
+
+        lastTime = time;
+        gfx.requestFrame(frame);
+    };
+
+    gfx.requestFrame(frame);
+});
@@ -0,0 +1,53 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    //create group
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //EPG like grid (row backgrounds split the batches)
+    const cols = 8;
+    const rows = 25;
+    const labels = [];
+
+    for (let row = 0; row < rows; row++) {
+        const rowGroup = this.createGroup().y(row * 24);
+
+        rowGroup.add(this.createRect().w(cols * 100).h(22).fill(row % 2 ? '#202020' : '#303030'));
+
+        for (let col = 0; col < cols; col++) {
+            const text = this.createText().x(col * 100 + 5).y(16).fontSize(14).text('Show ' + row + '/' + col).fill('#ffffff');
+
+            labels.push(text);
+            rowGroup.add(text);
+        }
+
+        g.add(rowGroup);
+    }
+
+    //change colors (no new layouts)
+    setInterval(() => {
+        for (const label of labels) {
+            label.opacity(0.5 + Math.random() * 0.5);
+        }
+    }, 100);
+
+    //stats
+    setInterval(() => {
+        const stats = gfx.getStats();
+
+        console.log(labels.length + ' labels: ' + stats.textDrawCalls + ' text draw calls' + (stats.fps ? ', ' + stats.fps.fps.toFixed(1) + ' fps' : ''));
+    }, 2000);
+});
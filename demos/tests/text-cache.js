@@ -0,0 +1,52 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    //create group
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //table with repeated cell values
+    const values = ['Open', 'Closed', 'Pending', 'Done', 'n/a'];
+    const cols = 5;
+    const rows = 30;
+    const cells = [];
+
+    for (let row = 0; row < rows; row++) {
+        for (let col = 0; col < cols; col++) {
+            const text = this.createText().x(col * 120 + 10).y(row * 20 + 20).w(110).fontSize(14).fill('#ffffff');
+
+            cells.push(text);
+            g.add(text);
+        }
+    }
+
+    //change all cells
+    let step = 0;
+
+    setInterval(() => {
+        for (let i = 0; i < cells.length; i++) {
+            cells[i].text(values[(i + step) % values.length]);
+        }
+
+        step++;
+    }, 100);
+
+    //stats
+    setInterval(() => {
+        const stats = gfx.getStats().textCache;
+
+        console.log('text cache: hit rate ' + (stats.hitRate * 100).toFixed(1) + '%, ' + stats.entries + ' entries, ' + (stats.memory / 1024).toFixed(1) + ' KB');
+    }, 2000);
+});
@@ -0,0 +1,51 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    const text = this.createText().x(10).y(40).w(this.w() - 20).h(this.h() - 40).wrap('word').fontSize(20).fill('#ffffff');
+
+    g.add(text);
+
+    //cache the short value
+    const cached = 'OK (no long text must be visible)';
+
+    text.text(cached);
+
+    //long text (laid out on the worker thread)
+    const words = [];
+
+    for (let i = 0; i < 2000; i++) {
+        words.push('word' + i);
+    }
+
+    const long = words.join(' ');
+
+    //change the text twice in a row (second value is cached)
+    let step = 0;
+
+    setInterval(() => {
+        text.text(long + ' ' + step);
+        step++;
+
+        setTimeout(() => {
+            //next frame: layout of the long text is still pending
+            text.text(cached);
+        }, 20);
+    }, 250);
+
+    console.log('expected: "' + cached + '" is shown all the time');
+});
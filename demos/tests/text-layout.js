@@ -0,0 +1,65 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+//text with 5000 distinct characters (missing characters use the fallback glyph of the font)
+const count = 5000;
+const chars = [];
+
+for (let i = 0; i < count; i++) {
+    chars.push(String.fromCharCode(0x20 + i));
+}
+
+const text = chars.join('');
+const loops = 100;
+
+amino.fonts.getFont({
+    name: 'noto-ui',
+    size: 10
+}, (err, font) => {
+    if (err) {
+        console.log('could not load font: ' + err.message);
+        return;
+    }
+
+    //load all glyphs
+    let start = process.hrtime();
+
+    font.calcTextWidth(text, () => {});
+
+    console.log('glyphs loaded: ' + elapsed(start).toFixed(1) + ' ms');
+
+    //layout
+    start = process.hrtime();
+
+    for (let i = 0; i < loops; i++) {
+        font.calcTextWidth(text, () => {});
+    }
+
+    console.log('layout: ' + (elapsed(start) / loops).toFixed(3) + ' ms (' + count + ' chars)');
+
+    //text node (wrapped)
+    const gfx = new amino.AminoGfx();
+
+    gfx.start(function (err) {
+        if (err) {
+            console.log('Amino error: ' + err.message);
+            return;
+        }
+
+        const textNode = this.createText().fontName('noto-ui').fontSize(10).w(this.w()).h(this.h()).wrap('word').text(text);
+
+        this.setRoot(this.createGroup().add(textNode));
+
+        //atlas pages
+        setTimeout(() => {
+            console.log('fonts: ' + JSON.stringify(this.getStats().fonts));
+        }, 1000);
+    });
+});
+
+function elapsed(start) {
+    const diff = process.hrtime(start);
+
+    return diff[0] * 1e3 + diff[1] / 1e6;
+}
@@ -0,0 +1,102 @@
+'use strict';
+
+const amino = require('../../main.js');
+const childProcess = require('child_process');
+
+//compare the first frame with and without preloading (separate processes, glyphs not loaded yet)
+const mode = process.argv[2];
+
+if (mode !== 'serial' && mode !== 'preload') {
+    for (const item of ['serial', 'preload']) {
+        childProcess.execFileSync(process.execPath, [__filename, item], { stdio: 'inherit' });
+    }
+
+    return;
+}
+
+//Latin-1 glyphs
+const charset = amino.fonts.charsets.latin1;
+const size = 30;
+let text = '';
+
+for (const range of charset) {
+    for (let codepoint = range[0]; codepoint <= range[1]; codepoint++) {
+        text += String.fromCodePoint(codepoint);
+    }
+}
+
+amino.fonts.getFont({
+    name: 'noto-ui',
+    size: size
+}, (err, font) => {
+    if (err) {
+        console.log('could not load font: ' + err.message);
+        return;
+    }
+
+    if (mode === 'serial') {
+        //glyphs are loaded by the first frame
+        firstFrame();
+        return;
+    }
+
+    //parallel
+    const start = process.hrtime();
+
+    font.preload(charset, (err, count) => {
+        if (err) {
+            console.log('preload error: ' + err.message);
+            return;
+        }
+
+        console.log('preload: ' + elapsed(start).toFixed(1) + ' ms (' + count + ' glyphs)');
+
+        firstFrame();
+    });
+});
+
+/**
+ * Measure the first frame showing the text.
+ *
+ * Note: offline frames lay out text synchronously and wait for the frame callback.
+ */
+function firstFrame() {
+    let start;
+    let done = false;
+
+    const gfx = new amino.AminoGfx({
+        offline: {
+            fps: 30,
+            frame: (pixels, info) => {
+                if (!gfx.root || done) {
+                    return;
+                }
+
+                if (!start) {
+                    //text is rendered in the next frame
+                    gfx.root.add(gfx.createText().x(10).y(50).w(gfx.w() - 20).wrap('word').fontName('noto-ui').fontSize(size).text(text));
+                    start = process.hrtime();
+                } else {
+                    done = true;
+                    console.log(mode + ': first frame ' + elapsed(start).toFixed(1) + ' ms');
+                    gfx.destroy();
+                }
+            }
+        }
+    });
+
+    gfx.start(function (err) {
+        if (err) {
+            console.log('Amino error: ' + err.message);
+            return;
+        }
+
+        this.setRoot(this.createGroup());
+    });
+}
+
+function elapsed(start) {
+    const diff = process.hrtime(start);
+
+    return diff[0] * 1e3 + diff[1] / 1e6;
+}
@@ -0,0 +1,42 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    //create group
+    const g = this.createGroup();
+
+    this.setRoot(g);
+
+    //bitmap glyphs (left) vs. signed distance field (right), both scaled
+    const normal = this.createText().x(20).y(100).fontSize(20).text('Scaled Text').fill('#ffffff');
+    const sdf = this.createText().x(this.w() / 2).y(100).fontSize(20).sdf(true).text('Scaled Text').fill('#ffffff');
+
+    g.add(normal, sdf);
+
+    normal.sx.anim().from(1).to(5).dur(4000).autoreverse(true).loop(-1).start();
+    normal.sy.anim().from(1).to(5).dur(4000).autoreverse(true).loop(-1).start();
+    sdf.sx.anim().from(1).to(5).dur(4000).autoreverse(true).loop(-1).start();
+    sdf.sy.anim().from(1).to(5).dur(4000).autoreverse(true).loop(-1).start();
+
+    //font sizes (all use the same SDF glyphs)
+    for (let i = 0; i < 8; i++) {
+        const size = 8 + i * 8;
+
+        g.add(this.createText().x(20).y(300 + i * (size + 10)).fontSize(size).sdf(true).text(size + 'px SDF').fill('#ffffff'));
+    }
+
+    //atlas pages
+    setTimeout(() => {
+        console.log('fonts: ' + JSON.stringify(this.getStats().fonts));
+    }, 1000);
+});
@@ -3,3 +3,20 @@
 const amino = require('../../main.js');
 
 console.log('time: ' + amino.AminoGfx.getTime());
+
+//frame clock
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    setInterval(() => {
+        const time = gfx.getTime();
+        const frameTime = gfx.getFrameTime();
+
+        console.log('time: ' + time.toFixed(3) + ', frame time: ' + frameTime.toFixed(3) + ', frame period: ' + gfx.getStats().framePeriod.toFixed(3) + ' ms');
+    }, 1000);
+});
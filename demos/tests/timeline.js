@@ -0,0 +1,62 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+const Timeline = amino.AminoGfx.Timeline;
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    const group = this.createGroup();
+
+    this.setRoot(group);
+
+    //rects
+    const rect1 = this.createRect().w(50).h(50).fill('#FF0000');
+    const rect2 = this.createRect().w(50).h(50).y(100).fill('#00FF00');
+    const rect3 = this.createRect().w(50).h(50).y(200).fill('#0000FF');
+
+    group.add(rect1, rect2, rect3);
+
+    //timeline: move rect1, then rect2 & rect3 together, fade all
+    const timeline = this.createTimeline()
+        .add(Timeline.sequence([
+            Timeline.track(rect1.x, [
+                { time: 0, value: 0 },
+                { time: 500, value: 300, timeFunc: 'cubicOut' },
+                { time: 1000, value: 200, timeFunc: 'cubic-bezier(0.68, -0.55, 0.27, 1.55)' }
+            ]),
+            Timeline.marker(() => console.log('rect1 done')),
+            Timeline.delay(250),
+            Timeline.parallel([
+                Timeline.track(rect2.x, [
+                    { time: 0, value: 0 },
+                    { time: 1000, value: 400 }
+                ]),
+                Timeline.track(rect3.x, [
+                    { time: 0, value: 400 },
+                    { time: 1000, value: 0, timeFunc: 'spring(200, 12, 1)' }
+                ])
+            ])
+        ]))
+        .track(group.opacity, [
+            { time: 0, value: 1 },
+            { time: 1125, value: 0.5 },
+            { time: 2250, value: 1 }
+        ])
+        .marker(2250, () => console.log('cycle done'))
+        .loop(3)
+        .then(() => {
+            console.log('timeline done: ' + rect1.x() + ' ' + rect2.x() + ' ' + rect3.x());
+
+            gfx.destroy();
+        });
+
+    timeline.start();
+});
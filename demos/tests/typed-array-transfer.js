@@ -0,0 +1,46 @@
+'use strict';
+
+const amino = require('../../main.js');
+
+const gfx = new amino.AminoGfx();
+
+gfx.start(function (err) {
+    if (err) {
+        console.log('Amino error: ' + err.message);
+        return;
+    }
+
+    this.fill('#000000');
+
+    const root = this.createGroup();
+
+    this.setRoot(root);
+
+    //polygon with 100k vertices (transferred, not copied)
+    const count = 100000;
+    const points = new Float32Array(count * 2);
+
+    for (let i = 0; i < count; i++) {
+        const angle = i / count * Math.PI * 2;
+
+        points[i * 2] = 300 + Math.cos(angle) * 200;
+        points[i * 2 + 1] = 300 + Math.sin(angle) * 200;
+    }
+
+    const poly = this.createPolygon().fill('#00ff00');
+    const start = process.hrtime();
+
+    poly.geometry(points);
+
+    const diff = process.hrtime(start);
+
+    root.add(poly);
+
+    console.log('assigned in ' + (diff[0] * 1e3 + diff[1] / 1e6).toFixed(3) + ' ms');
+    console.log('JS array detached: ' + (points.length === 0));
+
+    //getter returns a copy
+    const copy = poly.geometry();
+
+    console.log('getter: ' + copy.length + ' values (expected ' + count * 2 + ')');
+});
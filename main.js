@@ -84,6 +84,9 @@ AminoGfx.prototype.init = function () {
 
     //input handler
     this.inputHandler = input.createEventHandler(this);
+
+    //frame callbacks
+    this._frameCallbacks = [];
 };
 
 /**
@@ -174,6 +177,75 @@ AminoGfx.prototype.getRoot = function () {
     return this.root;
 };
 
+/**
+ * Build a node tree from a description.
+ *
+ * Nodes are objects with a type, their attributes and optional children:
+ *
+ *   { type: 'group', id: 'main', children: [ { type: 'rect', w: 100, h: 100, fill: '#ff0000' } ] }
+ *
+ * The description is read natively and all native values are applied in a single update. Native properties
+ * without listeners are set directly, their JS value is read on first access.
+ *
+ * @param desc JSON string or object.
+ * @return root node.
+ */
+AminoGfx.prototype.buildScene = function (desc) {
+    if (typeof desc === 'string') {
+        desc = JSON.parse(desc);
+    }
+
+    return this._buildScene(desc, getSceneTypes());
+};
+
+/**
+ * Save a node tree to a binary snapshot.
+ *
+ * Contains the node types, all property values and the children. Textures are referenced by their source,
+ * an error is thrown for textures or other objects which cannot be saved.
+ *
+ * @param node root node.
+ * @param file optional file path.
+ * @return snapshot buffer.
+ */
+AminoGfx.prototype.saveScene = function (node, file) {
+    const buffer = this._saveScene(node, getSceneTypes());
+
+    if (file) {
+        fs.writeFileSync(file, buffer);
+    }
+
+    return buffer;
+};
+
+/**
+ * Load a node tree from a binary snapshot.
+ *
+ * Files are memory mapped and loaded natively. Values of native properties without listeners are decoded
+ * directly into the native property, their JS value is read on first access.
+ *
+ * @param snapshot buffer or file path.
+ * @return root node.
+ */
+AminoGfx.prototype.loadScene = function (snapshot) {
+    return this._loadScene(snapshot, getSceneTypes());
+};
+
+/**
+ * Get the node types used by scene descriptions.
+ */
+function getSceneTypes() {
+    return {
+        group: AminoGfx.Group,
+        rect: AminoGfx.Rect,
+        imageView: AminoGfx.ImageView,
+        polygon: AminoGfx.Polygon,
+        model: AminoGfx.Model,
+        circle: AminoGfx.Circle,
+        text: AminoGfx.Text
+    };
+}
+
 /**
  * Create group element.
  */
@@ -291,6 +363,20 @@ AminoGfx.prototype.createText = function (attrs) {
     return text;
 };
 
+/**
+ * Create keyframe timeline.
+ */
+AminoGfx.prototype.createTimeline = function () {
+    return new AminoGfx.Timeline(this);
+};
+
+/**
+ * Create animation set.
+ */
+AminoGfx.prototype.createAnimSet = function () {
+    return new AminoGfx.AnimSet(this);
+};
+
 /**
  * Handle an event.
  */
@@ -345,6 +431,59 @@ function setSize(w, h) {
     this.w(w).h(h);
 }
 
+/**
+ * Request a callback after the next rendered frame.
+ *
+ * The callback gets the presentation time of the frame. All property updates of the frame were applied before.
+ */
+AminoGfx.prototype.requestFrame = function (cb) {
+    if (typeof cb !== 'function') {
+        throw new Error('function expected');
+    }
+
+    this._frameCallbacks.push(cb);
+
+    if (this._frameCallbacks.length === 1) {
+        this._requestFrame();
+    }
+
+    return this;
+};
+
+/**
+ * Cancel a pending frame callback.
+ */
+AminoGfx.prototype.cancelFrame = function (cb) {
+    const pos = this._frameCallbacks.indexOf(cb);
+
+    if (pos !== -1) {
+        this._frameCallbacks.splice(pos, 1);
+    }
+
+    return this;
+};
+
+/**
+ * Call the frame callbacks (native callback).
+ *
+ * Note: callbacks requested while handling the frame are called after the next frame.
+ */
+AminoGfx.prototype._handleFrame = function (time) {
+    const callbacks = this._frameCallbacks;
+
+    if (callbacks.length === 0) {
+        return;
+    }
+
+    this._frameCallbacks = [];
+
+    const count = callbacks.length;
+
+    for (let i = 0; i < count; i++) {
+        callbacks[i].call(this, time);
+    }
+};
+
 /**
  * Get runtime system info.
  */
@@ -355,6 +494,9 @@ AminoGfx.prototype.getStats = function () {
     stats.heapUsed = mem.heapUsed;
     stats.heapTotal = mem.heapTotal;
 
+    //font atlases
+    stats.fonts = fonts.getStats();
+
     return stats;
 };
 
@@ -387,11 +529,58 @@ AminoGfx.prototype.find = function (id) {
 
 /**
  * Find a node at a certain position with an optional filter callback.
+ *
+ * Uses the native hit index of the last rendered frame. Nodes and their parents are skipped if the filter returns false.
  */
 AminoGfx.prototype.findNodesAtXY = function (pt, filter) {
-    return findNodesAtXY(this.root, pt, filter, '');
+    const hits = this._findNodesAtXY(pt.x, pt.y);
+
+    if (!hits) {
+        //index not available yet
+        return findNodesAtXY(this.root, pt, filter, '');
+    }
+
+    const nodes = hits.nodes;
+    const coords = hits.coords;
+    const count = nodes.length;
+    const filtered = filter ? new Map() : null;
+    const res = [];
+
+    for (let i = 0; i < count; i++) {
+        const node = nodes[i];
+
+        //filter (node & parents)
+        if (filter && !acceptsFilter(node, filter, filtered)) {
+            continue;
+        }
+
+        //check shape
+        if (node.contains && node.contains(input.makePoint(coords[i * 2], coords[i * 2 + 1]))) {
+            res.push(node);
+        }
+    }
+
+    return res;
 };
 
+/**
+ * Check filter on node and its parents.
+ */
+function acceptsFilter(node, filter, cache) {
+    if (!node) {
+        return true;
+    }
+
+    let res = cache.get(node);
+
+    if (res === undefined) {
+        res = acceptsFilter(node.parent, filter, cache) && !!filter(node);
+        cache.set(node, res);
+    }
+
+    return res;
+}
+
 function findNodesAtXY(root, pt, filter, tab) {
     //verify
     if (!root || !root.visible()) {
@@ -435,67 +624,10 @@ function findNodesAtXY(root, pt, filter, tab) {
  * Find a node at a certain position.
  */
 AminoGfx.prototype.findNodeAtXY = function (x, y) {
-    return findNodeAtXY(this.root, x, y, '');
-};
-
-function findNodeAtXY(root, x, y, tab) {
-    if (!root) {
-        return null;
-    }
-
-    if (!root.visible()) {
-        return null;
-    }
-
-    let tx = x - root.x();
-    let ty = y - root.y();
-
-    tx /= root.sx();
-    ty /= root.sy();
-
-    //console.log(tab + "   xy="+tx+","+ty);
-
-    if (root.cliprect && root.clipRect()) {
-        if (tx < 0) {
-            return false;
-        }
-
-        if (tx > root.w()) {
-            return false;
-        }
-
-        if (ty < 0) {
-            return false;
-        }
-
-        if (ty > root.h()) {
-            return false;
-        }
-    }
-
-    if (root.children) {
-        //console.log(tab+"children = ",root.children.length);
-
-        for (let i = root.children.length - 1; i >= 0; i--) {
-            const node = root.children[i];
-            const found = this.findNodeAtXY(node, tx, ty, tab+ '  ');
-
-            if (found) {
-                return found;
-            }
-        }
-    }
-
-    //console.log(tab+"contains " + tx+' '+ty);
-
-    if (root.contains && root.contains(tx, ty)) {
-        //console.log(tab,"inside!",root.getId());
-
-        return root;
-    }
+    const nodes = this.findNodesAtXY(input.makePoint(x, y));
 
-    return null;
-}
+    return nodes.length > 0 ? nodes[0]:null;
+};
 
 /**
  * Convert screen coordinate to local node coordinate.
@@ -615,6 +747,59 @@ Group.prototype.init = function () {
     this.children = [];
 };
 
+/**
+ * Children.
+ *
+ * Note: removed children are kept as empty slots until the next access (O(1) removal).
+ */
+Object.defineProperty(Group.prototype, 'children', {
+    get: function () {
+        if (this._removedChildren > 0) {
+            compactChildren(this);
+        }
+
+        return this._children;
+    },
+    set: function (children) {
+        this._children = children;
+        this._removedChildren = 0;
+
+        updateChildIndices(children, 0);
+    }
+});
+
+/**
+ * Remove the empty slots of removed children.
+ */
+function compactChildren(group) {
+    const children = group._children;
+    const count = children.length;
+    let pos = 0;
+
+    for (let i = 0; i < count; i++) {
+        const child = children[i];
+
+        if (child) {
+            child._childIndex = pos;
+            children[pos++] = child;
+        }
+    }
+
+    children.length = pos;
+    group._removedChildren = 0;
+}
+
+/**
+ * Update the position of the children in their parent.
+ */
+function updateChildIndices(children, start) {
+    const count = children.length;
+
+    for (let i = start; i < count; i++) {
+        children[i]._childIndex = i;
+    }
+}
+
 /**
  * Check if point is inside of rect.
  */
@@ -665,7 +850,7 @@ Group.prototype.add = function () {
             throw new Error('can\'t add a null child to a group');
         }
 
-        if (this.children.indexOf(node) !== -1) {
+        if (node.parent === this) {
             throw new Error('child was added before');
         }
 
@@ -673,8 +858,12 @@ Group.prototype.add = function () {
             throw new Error('already added to different group');
         }
 
+        //Note: empty slots are kept (no compaction)
+        const children = this._children;
+
         this._add(node);
-        this.children.push(node);
+        node._childIndex = children.length;
+        children.push(node);
         node.parent = this;
     }
 
@@ -689,7 +878,7 @@ Group.prototype.insertAt = function (item, pos) {
         throw new Error('can\'t add a null child to a group');
     }
 
-    if (this.children.indexOf(item) !== -1) {
+    if (item.parent === this) {
         throw new Error('child was added before');
     }
 
@@ -699,16 +888,38 @@ Group.prototype.insertAt = function (item, pos) {
 
     this._insert(item, pos);
     this.children.splice(pos, 0, item);
+    updateChildIndices(this.children, pos);
     item.parent = this;
 
     return this;
 };
 
+/**
+ * Get the position of a child.
+ *
+ * @return position or -1 if not a child.
+ */
+function indexOfChild(group, node) {
+    if (!node || node.parent !== group) {
+        return -1;
+    }
+
+    const children = group.children;
+    const pos = node._childIndex;
+
+    if (children[pos] === node) {
+        return pos;
+    }
+
+    //fallback
+    return children.indexOf(node);
+}
+
 /**
  * Insert before a sibling.
  */
 Group.prototype.insertBefore = function (item, sibling) {
-    const pos = this.children.indexOf(sibling);
+    const pos = indexOfChild(this, sibling);
 
     if (pos == -1) {
         //add at end
@@ -724,7 +935,7 @@ Group.prototype.insertBefore = function (item, sibling) {
  * Insert after a sibling.
  */
 Group.prototype.insertAfter = function (item, sibling) {
-    const pos = this.children.indexOf(sibling);
+    const pos = indexOfChild(this, sibling);
 
     if (pos == -1) {
         //add at end
@@ -753,17 +964,57 @@ Group.prototype.remove = function () {
 
     for (let i = 0; i < count; i++) {
         const child = arguments[i];
-        const pos = this.children.indexOf(child);
 
-        if (pos >=  0) {
-            this._remove(child);
-            this.children.splice(pos, 1);
-            child.parent = null;
-        } else {
+        if (!child || child.parent !== this) {
             throw new Error('not a child');
         }
+
+        //empty slot (compacted on next access)
+        const children = this._children;
+        let pos = child._childIndex;
+
+        if (children[pos] !== child) {
+            //fallback (e.g. children assigned natively)
+            pos = children.indexOf(child);
+        }
+
+        this._remove(child);
+        children[pos] = null;
+        child._childIndex = -1;
+        child.parent = null;
+        this._removedChildren++;
+
+        //limit the empty slots (same threshold as native side)
+        if (this._removedChildren >= 32 && this._removedChildren * 2 >= children.length) {
+            compactChildren(this);
+        }
+    }
+
+    return this;
+};
+
+/**
+ * Remove a range of children.
+ */
+Group.prototype.removeRange = function (start, count) {
+    if (start < 0 || count < 0 || start + count > this.children.length) {
+        throw new Error('invalid range');
+    }
+
+    if (count === 0) {
+        return this;
+    }
+
+    const removed = this.children.splice(start, count);
+
+    for (let i = 0; i < count; i++) {
+        removed[i].parent = null;
     }
 
+    updateChildIndices(this.children, start);
+
+    this._removeRange(start, count, removed);
+
     return this;
 };
 
@@ -771,20 +1022,99 @@ Group.prototype.remove = function () {
  * Remove all children.
  */
 Group.prototype.clear = function () {
+    return this.removeRange(0, this.children.length);
+};
+
+/**
+ * Replace all children.
+ */
+Group.prototype.setChildren = function (nodes) {
+    const old = this.children;
+
+    //check
+    const added = new Set();
+
+    for (let i = 0; i < nodes.length; i++) {
+        const node = nodes[i];
+
+        if (!node) {
+            throw new Error('can\'t add a null child to a group');
+        }
+
+        if (node === this || (node.parent && node.parent !== this)) {
+            throw new Error('already added to different group');
+        }
+
+        if (added.has(node)) {
+            throw new Error('child was added before');
+        }
+
+        added.add(node);
+    }
+
+    //native (throws on error)
+    const children = nodes.slice();
+
+    this._setChildren(children, old);
+
+    //update
+    for (let i = 0; i < old.length; i++) {
+        old[i].parent = null;
+    }
+
+    for (let i = 0; i < children.length; i++) {
+        children[i].parent = this;
+    }
+
+    this.children = children;
+
+    return this;
+};
+
+/**
+ * Reorder the children.
+ *
+ * @param perm array of old positions (perm[newPos] = oldPos).
+ */
+Group.prototype.reorder = function (perm) {
     const count = this.children.length;
 
+    if (perm.length !== count) {
+        throw new Error('invalid permutation');
+    }
+
+    const used = new Uint8Array(count);
+    const children = new Array(count);
+
     for (let i = 0; i < count; i++) {
-        const child = this.children[i];
+        const pos = perm[i];
 
-        this._remove(child);
-        child.parent = null;
+        if (!Number.isInteger(pos) || pos < 0 || pos >= count || used[pos]) {
+            throw new Error('invalid permutation');
+        }
+
+        used[pos] = 1;
+        children[i] = this.children[pos];
     }
 
-    this.children = [];
+    this._reorder(Array.isArray(perm) ? perm : Array.from(perm));
+    this.children = children;
 
     return this;
 };
 
+/**
+ * Sort the children.
+ */
+Group.prototype.sort = function (compare) {
+    const children = this.children;
+    const perm = children.map((child, i) => i);
+
+    perm.sort((a, b) => compare(children[a], children[b]));
+
+    return this.reorder(perm);
+};
+
 /**
  * Bring child to top.
  */
@@ -793,6 +1123,14 @@ Group.prototype.raiseToTop = function (node) {
         throw new Error('can\'t move a null child');
     }
 
+    //check already on top (Note: no compaction)
+    const children = this._children;
+    const count = children.length;
+
+    if (count > 0 && children[count - 1] === node) {
+        return this;
+    }
+
     this.remove(node);
     this.add(node);
 
@@ -1463,7 +1801,7 @@ Polygon.prototype.init = function () {
         filled: true,
 
         dimension: 2, //2D
-        geometry: null
+        geometry: null //Note: Float32Array is transferred on assignment (detached), assign a new array to modify
     });
 
     this.fill.watch(setFill);
@@ -1549,7 +1887,7 @@ Model.prototype.init = function () {
         fillB: 0,
         opacity: 1.,
 
-        //properties
+        //properties (Note: Float32Array/Uint16Array values are transferred on assignment (detached), assign a new array to modify)
         vertices: null,
         indices: null,
         normals: null, //enables lighting
@@ -1875,7 +2213,11 @@ AminoFonts.prototype.getFont = function (descr, callback) {
     }
 
     const name = descr.name || this.defaultFont.name;
-    const size = Math.round(descr.size || 20);
+    const sdf = !!descr.sdf;
+    let size = descr.size || 20;
+
+    //Note: SDF fonts scale to any size (0.1 steps)
+    size = sdf ? Math.round(size * 10) / 10 : Math.round(size);
     let weight = descr.weight || 400;
     let style = descr.style || 'normal';
 
@@ -1942,12 +2284,12 @@ AminoFonts.prototype.getFont = function (descr, callback) {
     if (cached) {
         if (cached instanceof Promise) {
             cached.then(font => {
-                font.getSize(size, callback);
+                font.getSize(size, callback, sdf);
             }, err => {
                 callback(err);
             });
         } else {
-            cached.getSize(size, callback);
+            cached.getSize(size, callback, sdf);
         }
 
         return this;
@@ -1965,21 +2307,27 @@ AminoFonts.prototype.getFont = function (descr, callback) {
     const file = path.join(dir, styleDesc);
 
     const promise = new Promise((resolve, reject) => {
-        fs.readFile(file, (err, data) => {
+        fs.access(file, fs.constants.R_OK, err => {
             if (err) {
                 reject(err);
                 return;
             }
 
-            //throws exception on error
-            const font = new AminoFonts.Font(this, {
-                data: data,
-                file: file,
+            //Note: file is memory-mapped (shared by all fonts using the same file)
+            let font;
 
-                name: name,
-                weight: weight,
-                style: style
-            });
+            try {
+                font = new AminoFonts.Font(this, {
+                    file: file,
+
+                    name: name,
+                    weight: weight,
+                    style: style
+                });
+            } catch (e) {
+                reject(e);
+                return;
+            }
 
             resolve(font);
         });
@@ -1990,7 +2338,7 @@ AminoFonts.prototype.getFont = function (descr, callback) {
     promise.then(font => {
         this.cache[key] = font;
 
-        font.getSize(size, callback);
+        font.getSize(size, callback, sdf);
     }, err => {
         callback(err);
     });
@@ -1998,13 +2346,40 @@ AminoFonts.prototype.getFont = function (descr, callback) {
     return this;
 };
 
-const fonts = new AminoFonts();
+/**
+ * Get atlas statistics of all loaded fonts.
+ */
+AminoFonts.prototype.getStats = function () {
+    const stats = {};
 
-exports.fonts = fonts;
+    for (const key in this.cache) {
+        const font = this.cache[key];
 
-//
-// AminoFonts.Font
-//
+        if (font instanceof Promise) {
+            continue;
+        }
+
+        stats[key] = font._getStats();
+    }
+
+    return stats;
+};
+
+/**
+ * Common character sets (codepoint ranges).
+ */
+AminoFonts.prototype.charsets = {
+    ascii: [[0x20, 0x7E]],
+    latin1: [[0x20, 0x7E], [0xA0, 0xFF]]
+};
+
+const fonts = new AminoFonts();
+
+exports.fonts = fonts;
+
+//
+// AminoFonts.Font
+//
 
 const AminoFont = AminoFonts.Font;
 
@@ -2014,14 +2389,17 @@ AminoFont.prototype.init = function () {
 
 /**
  * Load font size.
+ *
+ * @param sdf use signed distance field glyphs (single atlas for all sizes).
  */
-AminoFont.prototype.getSize = function (size, callback) {
+AminoFont.prototype.getSize = function (size, callback, sdf) {
     //check cache
-    let fontSize = this.fontSizes[size];
+    const key = sdf ? 'sdf' + size : size;
+    let fontSize = this.fontSizes[key];
 
     if (!fontSize) {
-        fontSize = new AminoFonts.FontSize(this, size);
-        this.fontSizes[size] = fontSize;
+        fontSize = new AminoFonts.FontSize(this, size, !!sdf);
+        this.fontSizes[key] = fontSize;
     }
 
     callback(null, fontSize);
@@ -2040,6 +2418,32 @@ AminoFontSize.prototype.calcTextWidth = function (text, callback) {
     callback(null, this._calcTextWidth(text));
 };
 
+/**
+ * Load glyphs in the background.
+ *
+ * Glyphs are rendered in parallel and added to the atlas before the first text using them is shown.
+ *
+ * @param chars string or array of [from, to] codepoint ranges (see fonts.charsets).
+ * @param callback called with the number of new glyphs.
+ */
+AminoFontSize.prototype.preload = function (chars, callback) {
+    let str = chars;
+
+    if (Array.isArray(chars)) {
+        str = '';
+
+        for (const range of chars) {
+            for (let codepoint = range[0]; codepoint <= range[1]; codepoint++) {
+                str += String.fromCodePoint(codepoint);
+            }
+        }
+    } else if (typeof chars !== 'string') {
+        throw new Error('string or ranges expected');
+    }
+
+    this._preload(str, callback || (() => {}));
+};
+
 //
 // AminoGfxTexture
 //
@@ -2200,6 +2604,9 @@ Text.prototype.init = function () {
         fontStyle:  'normal',
         font:       null,
 
+        //signed distance field (sharp when scaled)
+        sdf:        false,
+
         //color
         r: 1,
         g: 1,
@@ -2230,6 +2637,7 @@ Text.prototype.initDone = function () {
     this.fontName.watch(this.updateFont);
     this.fontWeight.watch(this.updateFont);
     this.fontSize.watch(this.updateFont);
+    this.sdf.watch(this.updateFont);
 };
 
 /**
@@ -2269,6 +2677,7 @@ Text.prototype.updateFont = function (val, prop, obj) {
         size: obj.fontSize(),
         weight: obj.fontWeight(),
         style: obj.fontStyle(),
+        sdf: obj.sdf()
     }, (err, font) => {
         //handle errors
         if (err) {
@@ -2276,7 +2685,8 @@ Text.prototype.updateFont = function (val, prop, obj) {
 
             //try default font
             fonts.getFont({
-                size: obj.fontSize()
+                size: obj.fontSize(),
+                sdf: obj.sdf()
             }, (err, font) => {
                 if (err) {
                     if (DEBUG_ERRORS) {
@@ -2327,6 +2737,7 @@ Anim.prototype.init = function () {
     this._delay = 0;
     this._autoreverse = false;
     this._timeFunc = 'cubicInOut';
+    this._notify = 'always';
     this._then = null;
 
     this.started = false;
@@ -2423,17 +2834,82 @@ Anim.prototype.autoreverse = function (val) {
 //Time function values.
 const timeFuncs = [ 'linear', 'cubicIn', 'cubicOut', 'cubicInOut' ];
 
+//CSS time functions.
+const cssTimeFuncs = {
+    'ease': 'cubic-bezier(0.25,0.1,0.25,1)',
+    'ease-in': 'cubic-bezier(0.42,0,1,1)',
+    'ease-out': 'cubic-bezier(0,0,0.58,1)',
+    'ease-in-out': 'cubic-bezier(0.42,0,0.58,1)'
+};
+
+/**
+ * Internal: validate a time function.
+ *
+ * Values:
+ *
+ *   - 'linear', 'cubicIn', 'cubicOut', 'cubicInOut'
+ *   - 'ease', 'ease-in', 'ease-out', 'ease-in-out'
+ *   - 'cubic-bezier(x1, y1, x2, y2)' with x1 and x2 in [0, 1]
+ *   - 'spring(stiffness, damping, mass[, velocity])' (underdamped springs overshoot; the end value is set after the duration)
+ *
+ * @return normalized value.
+ */
+function parseTimeFunc(value) {
+    if (timeFuncs.indexOf(value) !== -1) {
+        return value;
+    }
+
+    if (cssTimeFuncs[value]) {
+        return cssTimeFuncs[value];
+    }
+
+    const match = typeof value === 'string' ? /^(cubic-bezier|spring)\(([^)]*)\)$/.exec(value.replace(/\s+/g, '')) : null;
+
+    if (match) {
+        const params = match[2].split(',').map(Number);
+
+        if (params.every(isFinite)) {
+            if (match[1] === 'cubic-bezier') {
+                if (params.length === 4 && params[0] >= 0 && params[0] <= 1 && params[2] >= 0 && params[2] <= 1) {
+                    return 'cubic-bezier(' + params.join(',') + ')';
+                }
+            } else if ((params.length === 3 || params.length === 4) && params[0] > 0 && params[1] >= 0 && params[2] > 0) {
+                return 'spring(' + params.join(',') + ')';
+            }
+        }
+    }
+
+    throw new Error('unknown time function: ' + value);
+}
+
 /**
  * Time function.
+ *
+ * See parseTimeFunc() for the supported values.
  */
 Anim.prototype.timeFunc = function (value) {
     this.checkStarted();
 
-    if (timeFuncs.indexOf(value) === -1) {
-        throw new Error('unknown time function: ' + value);
+    this._timeFunc = parseTimeFunc(value);
+
+    return this;
+};
+
+/**
+ * JS property notifications while running.
+ *
+ * Values: 'always', 'end' (only the end value) or a rate in Hz.
+ *
+ * Note: properties without listeners are never updated while running. Their value is read on demand.
+ */
+Anim.prototype.notify = function (value) {
+    this.checkStarted();
+
+    if (value !== 'always' && value !== 'end' && !(typeof value === 'number' && value > 0)) {
+        throw new Error('unknown notify value: ' + value);
     }
 
-    this._timeFunc = value;
+    this._notify = value;
 
     return this;
 };
@@ -2485,6 +2961,7 @@ Anim.prototype.start = function (refTime) {
             count: this._loop,
             autoreverse: this._autoreverse,
             timeFunc: this._timeFunc,
+            notify: this._notify,
             then: this._then
         });
     }, this._delay);
@@ -2492,6 +2969,399 @@ Anim.prototype.start = function (refTime) {
     return this;
 };
 
+//
+// Timeline
+//
+
+const Timeline = AminoGfx.Timeline;
+
+/**
+ * Initialize instance.
+ */
+Timeline.prototype.init = function () {
+    this._items = [];
+    this._markers = [];
+    this._loop = 1;
+    this._then = null;
+
+    this.started = false;
+};
+
+/**
+ * Keyframe track of a property.
+ *
+ * Keyframes: [{ time: ms, value: number, timeFunc: 'linear' }]. The time function is used for the segment ending at the keyframe
+ * (see Anim.timeFunc()).
+ */
+Timeline.track = function (prop, keyframes) {
+    if (typeof prop !== 'function' || !prop.keyframes) {
+        throw new Error('not an amino property');
+    }
+
+    return prop.keyframes(keyframes);
+};
+
+/**
+ * Run items one after the other.
+ */
+Timeline.sequence = function (items) {
+    return {
+        type: 'sequence',
+        items: items
+    };
+};
+
+/**
+ * Run items at the same time.
+ */
+Timeline.parallel = function (items) {
+    return {
+        type: 'parallel',
+        items: items
+    };
+};
+
+/**
+ * Pause in a sequence.
+ */
+Timeline.delay = function (duration) {
+    return {
+        type: 'delay',
+        duration: duration
+    };
+};
+
+/**
+ * Marker callback in a sequence.
+ */
+Timeline.marker = function (fun) {
+    return {
+        type: 'marker',
+        fun: fun
+    };
+};
+
+/**
+ * Add a track, sequence or parallel group.
+ *
+ * @param item timeline item.
+ * @param offset optional start time.
+ */
+Timeline.prototype.add = function (item, offset) {
+    this.checkStarted();
+
+    this._items.push({
+        item: item,
+        offset: offset || 0
+    });
+
+    return this;
+};
+
+/**
+ * Add a keyframe track.
+ */
+Timeline.prototype.track = function (prop, keyframes, offset) {
+    return this.add(Timeline.track(prop, keyframes), offset);
+};
+
+/**
+ * Add a marker callback.
+ */
+Timeline.prototype.marker = function (time, fun) {
+    return this.add(Timeline.marker(fun), time);
+};
+
+/**
+ * Number of cycles (-1 for forever).
+ */
+Timeline.prototype.loop = function (val) {
+    this.checkStarted();
+
+    this._loop = val;
+
+    return this;
+};
+
+/**
+ * End callback.
+ */
+Timeline.prototype.then = function (fun) {
+    this.checkStarted();
+
+    this._then = fun;
+
+    return this;
+};
+
+/**
+ * Internal: check started state.
+ */
+Timeline.prototype.checkStarted = Anim.prototype.checkStarted;
+
+/**
+ * Internal: flatten an item to absolute keyframe times.
+ *
+ * @return end time.
+ */
+function flattenTimelineItem(item, offset, out) {
+    let end = offset;
+
+    switch (item.type) {
+        case 'track': {
+            const times = [];
+            const values = [];
+            const easing = [];
+
+            for (let key of item.keyframes) {
+                const timeFunc = parseTimeFunc(key.timeFunc || 'linear');
+
+                times.push(offset + key.time);
+                values.push(key.value);
+                easing.push(timeFunc);
+            }
+
+            if (times.length === 0) {
+                throw new Error('missing keyframes');
+            }
+
+            out.tracks.push({
+                node: item.node,
+                propId: item.propId,
+                times: times,
+                values: values,
+                easing: easing
+            });
+
+            return times[times.length - 1];
+        }
+
+        case 'sequence':
+            for (let child of item.items) {
+                end = flattenTimelineItem(child, end, out);
+            }
+
+            return end;
+
+        case 'parallel':
+            for (let child of item.items) {
+                end = Math.max(end, flattenTimelineItem(child, offset, out));
+            }
+
+            return end;
+
+        case 'delay':
+            return offset + item.duration;
+
+        case 'marker':
+            out.markers.push({
+                time: offset,
+                fun: item.fun
+            });
+
+            return offset;
+
+        default:
+            throw new Error('unknown timeline item: ' + item.type);
+    }
+}
+
+/**
+ * Start the timeline.
+ */
+Timeline.prototype.start = function (refTime) {
+    if (this.started) {
+        throw new Error('timeline already started');
+    }
+
+    this.started = true;
+
+    //flatten
+    const out = {
+        tracks: [],
+        markers: []
+    };
+    let duration = 0;
+
+    for (let entry of this._items) {
+        duration = Math.max(duration, flattenTimelineItem(entry.item, entry.offset, out));
+    }
+
+    //markers (stable order)
+    const markers = out.markers.map((marker, index) => {
+        marker.index = index;
+
+        return marker;
+    }).sort((a, b) => a.time - b.time || a.index - b.index);
+
+    this._markers = markers.map(marker => marker.fun);
+
+    //native start
+    this._start({
+        tracks: out.tracks,
+        markers: markers.map(marker => marker.time),
+        marker: index => {
+            const fun = this._markers[index];
+
+            if (fun) {
+                fun.call(this);
+            }
+        },
+        duration: duration,
+        refTime: refTime,
+        count: this._loop,
+        then: this._then
+    });
+
+    return this;
+};
+
+//
+// AnimSet
+//
+
+const AnimSet = AminoGfx.AnimSet;
+
+/**
+ * Initialize instance.
+ */
+AnimSet.prototype.init = function () {
+    this._nodes = [];
+    this._propIds = [];
+    this._delays = [];
+    this._scales = [];
+    this._offsets = [];
+
+    this._from = 0;
+    this._to = 1;
+    this._duration = 1000;
+    this._loop = 1;
+    this._autoreverse = false;
+    this._timeFunc = 'cubicInOut';
+    this._then = null;
+
+    this.started = false;
+};
+
+/**
+ * Add a target property.
+ *
+ * Options: { delay: ms, scale: 1, offset: 0 }. The property is set to offset + scale * curve value.
+ */
+AnimSet.prototype.add = function (prop, opts) {
+    this.checkStarted();
+
+    if (typeof prop !== 'function' || !prop.keyframes) {
+        throw new Error('not an amino property');
+    }
+
+    //target (see prop.keyframes())
+    const target = prop.keyframes();
+
+    opts = opts || {};
+
+    this._nodes.push(target.node);
+    this._propIds.push(target.propId);
+    this._delays.push(opts.delay || 0);
+    this._scales.push(opts.scale === undefined ? 1 : opts.scale);
+    this._offsets.push(opts.offset || 0);
+
+    return this;
+};
+
+/**
+ * Add target properties with a staggered delay.
+ *
+ * Options: { delay: ms, stagger: ms, scale: 1, offset: 0 }. Each target starts stagger ms after the previous one.
+ */
+AnimSet.prototype.addAll = function (props, opts) {
+    opts = opts || {};
+
+    const delay = opts.delay || 0;
+    const stagger = opts.stagger || 0;
+    const count = props.length;
+
+    for (let i = 0; i < count; i++) {
+        this.add(props[i], {
+            delay: delay + i * stagger,
+            scale: opts.scale,
+            offset: opts.offset
+        });
+    }
+
+    return this;
+};
+
+/**
+ * Start value of the curve.
+ */
+AnimSet.prototype.from = Anim.prototype.from;
+
+/**
+ * End value of the curve.
+ */
+AnimSet.prototype.to = Anim.prototype.to;
+
+/**
+ * Duration of the curve (per target).
+ */
+AnimSet.prototype.dur = Anim.prototype.dur;
+
+/**
+ * Number of cycles (-1 for forever).
+ */
+AnimSet.prototype.loop = Anim.prototype.loop;
+
+/**
+ * Auto reverse every other cycle.
+ */
+AnimSet.prototype.autoreverse = Anim.prototype.autoreverse;
+
+/**
+ * Time function (see Anim.timeFunc()).
+ */
+AnimSet.prototype.timeFunc = Anim.prototype.timeFunc;
+
+/**
+ * End callback (called once after all targets finished).
+ */
+AnimSet.prototype.then = Anim.prototype.then;
+
+/**
+ * Internal: check started state.
+ */
+AnimSet.prototype.checkStarted = Anim.prototype.checkStarted;
+
+/**
+ * Start the animation set.
+ */
+AnimSet.prototype.start = function (refTime) {
+    if (this.started) {
+        throw new Error('animation set already started');
+    }
+
+    this.started = true;
+
+    //native start
+    this._start({
+        nodes: this._nodes,
+        propIds: this._propIds,
+        delays: this._delays,
+        scales: this._scales,
+        offsets: this._offsets,
+        from: this._from,
+        to: this._to,
+        duration: this._duration,
+        refTime: refTime,
+        count: this._loop,
+        autoreverse: this._autoreverse,
+        timeFunc: this._timeFunc,
+        then: this._then
+    });
+
+    return this;
+};
+
 /**
  * Create properties.
  */
@@ -2528,6 +3398,10 @@ function makeProp(obj, name, val) {
     prop.propName = name;
     prop.readonly = false;
     prop.nativeListener = null;
+    prop.nativeWatcher = null;
+    prop.nativeValue = null;
+    prop.stale = false;
+    prop.sceneSynced = false;
     prop.listeners = [];
 
     /**
@@ -2542,6 +3416,11 @@ function makeProp(obj, name, val) {
 
         this.listeners.push(fun);
 
+        //first listener
+        if (this.listeners.length === 1 && this.nativeWatcher) {
+            this.nativeWatcher(true, this.propId, obj);
+        }
+
         return this;
     };
 
@@ -2556,19 +3435,54 @@ function makeProp(obj, name, val) {
         }
 
         this.listeners.splice(n, 1);
+
+        //last listener
+        if (this.listeners.length === 0 && this.nativeWatcher) {
+            this.nativeWatcher(false, this.propId, obj);
+        }
     };
 
     /**
      * Remove all listeners.
      */
     prop.unwatchAll = function () {
+        if (this.listeners.length > 0 && this.nativeWatcher) {
+            this.nativeWatcher(false, this.propId, obj);
+        }
+
         this.listeners = [];
     };
 
+    /**
+     * Read a value set natively by a scene build (once).
+     */
+    prop.syncScene = function (obj) {
+        this.sceneSynced = true;
+
+        if (this.nativeValue && !this.stale) {
+            const v = this.nativeValue(this.propId, obj, true);
+
+            if (v !== undefined) {
+                this.value = v;
+            }
+        }
+    };
+
     /**
      * Getter function.
      */
     prop.get = function () {
+        //value set by scene
+        if (obj._sceneProps && !this.sceneSynced) {
+            this.syncScene(obj);
+        }
+
+        //value skipped by animation
+        if (this.stale) {
+            this.stale = false;
+            this.value = this.nativeValue(this.propId, obj);
+        }
+
         return this.value;
     };
 
@@ -2582,8 +3496,13 @@ function makeProp(obj, name, val) {
             return obj;
         }
 
+        //value set by scene
+        if (obj._sceneProps && !this.sceneSynced) {
+            this.syncScene(obj);
+        }
+
         //check if modified
-        if (v === this.value) {
+        if (v === this.value && !this.stale) {
             //debug
             //console.log('not changed: ' + name);
 
@@ -2592,11 +3511,15 @@ function makeProp(obj, name, val) {
 
         //update
         this.value = v;
+        this.stale = false;
 
         //native listener
         if (this.nativeListener && !nativeCall) {
             //prevent recursion in case of updates from native side
-            this.nativeListener(this.value, this.propId, obj);
+            if (this.nativeListener(this.value, this.propId, obj)) {
+                //transferred to native side (typed arrays), read a copy on demand
+                this.stale = true;
+            }
         }
 
         //fire listeners
@@ -2630,6 +3553,28 @@ function makeProp(obj, name, val) {
         return anim;
     };
 
+    /**
+     * Create timeline track.
+     *
+     * See Timeline.track().
+     */
+    prop.keyframes = function (keyframes) {
+        if (!obj.amino) {
+            throw new Error('not an amino object');
+        }
+
+        if (!this.propId) {
+            throw new Error('property cannot be animated');
+        }
+
+        return {
+            type: 'track',
+            node: obj,
+            propId: this.propId,
+            keyframes: keyframes
+        };
+    };
+
     /**
      * Bind to other property.
      *
@@ -2646,7 +3591,7 @@ function makeProp(obj, name, val) {
             }
         }
 
-        prop.listeners.push(watcher);
+        prop.watch(watcher);
 
         //apply current value
         watcher(prop());
@@ -2678,7 +3623,7 @@ function makeProp(obj, name, val) {
                 //normal assignment
                 prop(value);
             } else {
-                console.log('unknown attribute: ' + key);
+                throw new Error('unknown attribute: ' + key);
             }
         }
 
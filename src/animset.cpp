@@ -0,0 +1,496 @@
+#include "animset.h"
+
+#include <algorithm>
+
+#define DEBUG_ANIMSET false
+
+//
+// AminoAnimSet
+//
+
+/**
+ * Constructor.
+ */
+AminoAnimSet::AminoAnimSet(): AminoJSObject(getFactory()->name) {
+    //empty
+}
+
+/**
+ * Destructor.
+ */
+AminoAnimSet::~AminoAnimSet() {
+    if (!destroyed) {
+        destroyAminoAnimSet();
+    }
+}
+
+/**
+ * Handle JS constructor params.
+ */
+void AminoAnimSet::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
+    assert(info.Length() == 1);
+
+    //params
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info[0]->ToObject());
+
+    assert(obj);
+
+    //bind to queue (retains AminoGfx reference)
+    this->setEventHandler(obj);
+}
+
+/**
+ * Free all resources.
+ */
+void AminoAnimSet::destroy() {
+    if (destroyed) {
+        return;
+    }
+
+    //instance
+    destroyAminoAnimSet();
+
+    //base class
+    AminoJSObject::destroy();
+}
+
+/**
+ * Free instance data.
+ */
+void AminoAnimSet::destroyAminoAnimSet() {
+    std::size_t targetCount = targetProps.size();
+
+    for (std::size_t i = 0; i < targetCount; i++) {
+        targetProps[i]->release();
+    }
+
+    targetProps.clear();
+
+    if (easing) {
+        delete easing;
+        easing = NULL;
+    }
+
+    if (then) {
+        delete then;
+        then = NULL;
+    }
+}
+
+/**
+ * Create animation set factory.
+ */
+AminoAnimSetFactory* AminoAnimSet::getFactory() {
+    static AminoAnimSetFactory *animSetFactory = NULL;
+
+    if (!animSetFactory) {
+        animSetFactory = new AminoAnimSetFactory(New);
+    }
+
+    return animSetFactory;
+}
+
+/**
+ * Initialize AnimSet template.
+ */
+v8::Local<v8::FunctionTemplate> AminoAnimSet::GetInitFunction() {
+    v8::Local<v8::FunctionTemplate> tpl = AminoJSObject::createTemplate(getFactory());
+
+    //methods
+    Nan::SetPrototypeMethod(tpl, "_start", Start);
+    Nan::SetPrototypeMethod(tpl, "stop", Stop);
+
+    //template function
+    return tpl;
+}
+
+/**
+ * JS object construction.
+ */
+NAN_METHOD(AminoAnimSet::New) {
+    AminoJSObject::createInstance(info, getFactory());
+}
+
+/**
+ * Start animation set.
+ */
+NAN_METHOD(AminoAnimSet::Start) {
+    assert(info.Length() == 1);
+
+    AminoAnimSet *obj = Nan::ObjectWrap::Unwrap<AminoAnimSet>(info.This());
+    v8::Local<v8::Object> data = info[0]->ToObject();
+
+    assert(obj);
+
+    obj->handleStart(data);
+}
+
+/**
+ * Start animation set.
+ *
+ * Note: the rendering thread sees the animation set after all targets were added.
+ */
+void AminoAnimSet::handleStart(v8::Local<v8::Object> &data) {
+    if (started) {
+        Nan::ThrowTypeError("already started");
+        return;
+    }
+
+    if (destroyed) {
+        Nan::ThrowTypeError("animation set was stopped");
+        return;
+    }
+
+    //targets
+    if (!addTargets(data)) {
+        return;
+    }
+
+    //curve
+    from     = Nan::Get(data, Nan::New<v8::String>("from").ToLocalChecked()).ToLocalChecked()->NumberValue();
+    to       = Nan::Get(data, Nan::New<v8::String>("to").ToLocalChecked()).ToLocalChecked()->NumberValue();
+    duration = Nan::Get(data, Nan::New<v8::String>("duration").ToLocalChecked()).ToLocalChecked()->NumberValue();
+
+    Nan::Utf8String str(Nan::Get(data, Nan::New<v8::String>("timeFunc").ToLocalChecked()).ToLocalChecked());
+    std::string tf = std::string(*str);
+
+    timeFunc = AminoAnim::parseTimeFunc(tf);
+    easing = AminoEasing::parse(tf, duration);
+
+    //parameters
+    count       = Nan::Get(data, Nan::New<v8::String>("count").ToLocalChecked()).ToLocalChecked()->IntegerValue();
+    autoreverse = Nan::Get(data, Nan::New<v8::String>("autoreverse").ToLocalChecked()).ToLocalChecked()->BooleanValue();
+
+    //cycle: all targets finished
+    std::size_t targetCount = targetDelay.size();
+
+    cycleDuration = duration;
+
+    for (std::size_t i = 0; i < targetCount; i++) {
+        cycleDuration = std::max(cycleDuration, targetDelay[i] + duration);
+    }
+
+    //then
+    v8::Local<v8::Value> thenLocal = Nan::Get(data, Nan::New<v8::String>("then").ToLocalChecked()).ToLocalChecked();
+
+    if (thenLocal->IsFunction()) {
+        then = new Nan::Callback(thenLocal.As<v8::Function>());
+    }
+
+    //refTime
+    v8::Local<v8::Value> refTimeLocal = Nan::Get(data, Nan::New<v8::String>("refTime").ToLocalChecked()).ToLocalChecked();
+
+    if (refTimeLocal->IsNumber()) {
+        hasRefTime = true;
+        refTime = refTimeLocal->NumberValue();
+    }
+
+    if (DEBUG_ANIMSET) {
+        printf("anim set: %i targets, duration %f, cycle %f\n", (int)targetProps.size(), duration, cycleDuration);
+    }
+
+    //enqueue (Note: stop() has to be called to free the instance)
+    started = true;
+
+    (static_cast<AminoGfx *>(eventHandler))->addAnimSet(this);
+}
+
+/**
+ * Add all targets.
+ *
+ * Data: { nodes, propIds, delays, scales, offsets } (arrays of the same length)
+ */
+bool AminoAnimSet::addTargets(v8::Local<v8::Object> &data) {
+    v8::Local<v8::Array> nodes = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("nodes").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> propIds = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("propIds").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> delays = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("delays").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> scales = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("scales").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> offsets = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("offsets").ToLocalChecked()).ToLocalChecked());
+    uint32_t targetCount = nodes->Length();
+
+    if (propIds->Length() != targetCount || delays->Length() != targetCount || scales->Length() != targetCount || offsets->Length() != targetCount) {
+        Nan::ThrowTypeError("invalid targets");
+        return false;
+    }
+
+    AminoGfx *gfx = static_cast<AminoGfx *>(eventHandler);
+
+    targetProps.reserve(targetCount);
+    targetDelay.reserve(targetCount);
+    targetScale.reserve(targetCount);
+    targetOffset.reserve(targetCount);
+    targetState.reserve(targetCount);
+
+    for (uint32_t i = 0; i < targetCount; i++) {
+        AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(nodes->Get(i)->ToObject());
+
+        assert(node);
+
+        if (!node->checkRenderer(gfx)) {
+            return false;
+        }
+
+        //get property
+        AnyProperty *prop = node->getPropertyWithId(propIds->Get(i)->Uint32Value());
+
+        if (!prop || prop->type != PROPERTY_FLOAT) {
+            Nan::ThrowTypeError("property cannot be animated");
+            return false;
+        }
+
+        //retain property (released by destroy())
+        prop->retain();
+
+        targetProps.push_back(static_cast<FloatProperty *>(prop));
+        targetDelay.push_back(delays->Get(i)->NumberValue());
+        targetScale.push_back(scales->Get(i)->NumberValue());
+        targetOffset.push_back(offsets->Get(i)->NumberValue());
+        targetState.push_back(TARGET_WAITING);
+    }
+
+    return true;
+}
+
+/**
+ * Stop and destroy animation set.
+ */
+NAN_METHOD(AminoAnimSet::Stop) {
+    AminoAnimSet *obj = Nan::ObjectWrap::Unwrap<AminoAnimSet>(info.This());
+
+    assert(obj);
+
+    obj->stop();
+}
+
+/**
+ * Stop animation set.
+ *
+ * Note: has to be called on main thread!
+ */
+void AminoAnimSet::stop() {
+    if (!destroyed) {
+        //keep instance until destroyed
+        retain();
+
+        //remove animation set
+        if (eventHandler) {
+            (static_cast<AminoGfx *>(eventHandler))->removeAnimSet(this);
+        }
+
+        //free resources
+        destroy();
+
+        //release instance
+        release();
+    }
+}
+
+/**
+ * Reset all targets to the beginning of a cycle.
+ */
+void AminoAnimSet::rewind() {
+    std::size_t targetCount = targetState.size();
+
+    for (std::size_t i = 0; i < targetCount; i++) {
+        targetState[i] = TARGET_WAITING;
+    }
+}
+
+/**
+ * Evaluate all targets at a cycle position.
+ *
+ * Targets keep their value until their delay has passed. The end value is applied once.
+ *
+ * @param t cycle time.
+ * @param notify always update the JS values (end state).
+ */
+void AminoAnimSet::evaluate(float t, bool notify) {
+    std::size_t targetCount = targetProps.size();
+    const float *delays = targetDelay.data();
+    const float *scales = targetScale.data();
+    const float *offsets = targetOffset.data();
+    uint8_t *states = targetState.data();
+    float start = reverse ? to : from;
+    float range = reverse ? from - to : to - from;
+
+    for (std::size_t i = 0; i < targetCount; i++) {
+        if (states[i] == TARGET_DONE) {
+            continue;
+        }
+
+        float local = t - delays[i];
+
+        if (local < 0) {
+            //not started yet
+            continue;
+        }
+
+        FloatProperty *prop = targetProps[i];
+        float p;
+
+        if (local >= duration) {
+            //end value (always sent to JS)
+            states[i] = TARGET_DONE;
+            prop->setValue(offsets[i] + scales[i] * (start + range), true);
+            continue;
+        }
+
+        states[i] = TARGET_RUNNING;
+
+        //curve (reverse runs backwards in time)
+        float f = local / duration;
+
+        if (reverse) {
+            f = 1 - f;
+            p = easing ? easing->apply(f) : AminoAnim::applyTimeFunc(timeFunc, f);
+            p = 1 - p;
+        } else {
+            p = easing ? easing->apply(f) : AminoAnim::applyTimeFunc(timeFunc, f);
+        }
+
+        prop->setValue(offsets[i] + scales[i] * (start + range * p), notify || prop->watched);
+    }
+}
+
+/**
+ * Next animation step.
+ *
+ * Note: called on rendering thread.
+ */
+void AminoAnimSet::update(double currentTime) {
+    //check active
+    if (!started || ended) {
+        return;
+    }
+
+    //check remaining loops
+    if (count == 0 || duration <= 0) {
+        evaluate(cycleDuration, true);
+        endAnimSet();
+        return;
+    }
+
+    //handle first start
+    if (startTime == 0) {
+        startTime = currentTime;
+        lastTime = currentTime;
+
+        //sync with reference time
+        if (hasRefTime) {
+            if (currentTime < refTime) {
+                //in future: wait
+                startTime = 0;
+                lastTime = 0;
+                return;
+            }
+
+            startTime = refTime;
+        }
+    }
+
+    //validate time (should never happen if time is monotonic)
+    if (currentTime < lastTime) {
+        startTime = currentTime - (lastTime - startTime);
+    }
+
+    lastTime = currentTime;
+
+    //check cycle end
+    double t = currentTime - startTime;
+
+    if (t >= cycleDuration) {
+        int cycles = t / cycleDuration;
+
+        if (count != FOREVER) {
+            if (cycles >= count) {
+                //end reached (direction of the last cycle)
+                if (autoreverse && (count - 1) % 2 == 1) {
+                    reverse = !reverse;
+                    rewind();
+                }
+
+                evaluate(cycleDuration, true);
+                endAnimSet();
+                return;
+            }
+
+            count -= cycles;
+        }
+
+        //next cycle
+        startTime += cycles * cycleDuration;
+        t -= cycles * cycleDuration;
+
+        if (autoreverse && cycles % 2 == 1) {
+            reverse = !reverse;
+        }
+
+        rewind();
+    }
+
+    evaluate(t, false);
+}
+
+/**
+ * End the animation set.
+ */
+void AminoAnimSet::endAnimSet() {
+    if (ended) {
+        return;
+    }
+
+    if (DEBUG_ANIMSET) {
+        printf("AnimSet: endAnimSet()\n");
+    }
+
+    ended = true;
+
+    //callback function
+    if (then) {
+        //Note: not using async Nan call to keep order with stop
+        enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoAnimSet::callThen), NULL, NULL);
+    }
+
+    //stop
+    enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoAnimSet::callStop), NULL, NULL);
+}
+
+/**
+ * Perform then() call on main thread.
+ */
+void AminoAnimSet::callThen(JSCallbackUpdate *update) {
+    if (!then) {
+        return;
+    }
+
+    //create scope
+    Nan::HandleScope scope;
+
+    //call
+    Nan::Call(*then, handle(), 0, NULL);
+}
+
+/**
+ * Perform stop() call on main thread.
+ */
+void AminoAnimSet::callStop(JSCallbackUpdate *update) {
+    stop();
+}
+
+//
+// AminoAnimSetFactory
+//
+
+/**
+ * Animation set factory constructor.
+ */
+AminoAnimSetFactory::AminoAnimSetFactory(Nan::FunctionCallback callback): AminoJSObjectFactory("AminoAnimSet", callback) {
+    //empty
+}
+
+/**
+ * Create animation set instance.
+ */
+AminoJSObject* AminoAnimSetFactory::create() {
+    return new AminoAnimSet();
+}
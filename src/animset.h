@@ -0,0 +1,99 @@
+#ifndef _AMINOANIMSET_H
+#define _AMINOANIMSET_H
+
+#include "base.h"
+
+#include <stdint.h>
+
+class AminoAnimSetFactory;
+
+/**
+ * Animation set.
+ *
+ * Applies one curve to any number of float properties. Each target has its own delay and maps the curve value with
+ * scale and offset (value = offset + scale * curve). Used for staggered animations of many nodes.
+ *
+ * Targets are stored as structure of arrays and evaluated in a single pass on the rendering thread. There is a single
+ * completion callback for all targets.
+ */
+class AminoAnimSet : public AminoJSObject {
+public:
+    AminoAnimSet();
+    ~AminoAnimSet();
+
+    void preInit(Nan::NAN_METHOD_ARGS_TYPE info) override;
+    void destroy() override;
+
+    //creation
+    static AminoAnimSetFactory* getFactory();
+    static v8::Local<v8::FunctionTemplate> GetInitFunction();
+
+    void stop();
+    void update(double currentTime);
+
+private:
+    bool started = false;
+    bool ended = false;
+
+    //targets
+    std::vector<FloatProperty *> targetProps;
+    std::vector<float> targetDelay;
+    std::vector<float> targetScale;
+    std::vector<float> targetOffset;
+    std::vector<uint8_t> targetState;
+
+    //curve
+    float from = 0;
+    float to = 0;
+    float duration = 0;
+    int timeFunc = 0;
+    AminoEasing *easing = NULL;
+
+    //properties
+    float cycleDuration = 0;
+    int count = 1;
+    bool autoreverse = false;
+    bool reverse = false;
+    Nan::Callback *then = NULL;
+
+    //sync time
+    double refTime = 0;
+    bool hasRefTime = false;
+
+    double startTime = 0;
+    double lastTime = 0;
+
+    static const int FOREVER = -1;
+
+    static const uint8_t TARGET_WAITING = 0;
+    static const uint8_t TARGET_RUNNING = 1;
+    static const uint8_t TARGET_DONE    = 2;
+
+    void destroyAminoAnimSet();
+
+    void handleStart(v8::Local<v8::Object> &data);
+    bool addTargets(v8::Local<v8::Object> &data);
+
+    void rewind();
+    void evaluate(float t, bool notify);
+    void endAnimSet();
+
+    void callThen(JSCallbackUpdate *update);
+    void callStop(JSCallbackUpdate *update);
+
+    static NAN_METHOD(New);
+    static NAN_METHOD(Start);
+    static NAN_METHOD(Stop);
+};
+
+/**
+ * Animation set factory.
+ */
+class AminoAnimSetFactory : public AminoJSObjectFactory {
+public:
+    AminoAnimSetFactory(Nan::FunctionCallback callback);
+
+    AminoJSObject* create() override;
+};
+
+#endif
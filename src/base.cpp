@@ -1,9 +1,17 @@
 #include "base.h"
 
 #include <cwctype>
+#include <cmath>
 #include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "renderer.h"
+#include "timeline.h"
+#include "animset.h"
 #include "fonts/utf8-utils.h"
 
 #define DEBUG_RENDERER false
@@ -13,6 +21,10 @@
 #define MEASURE_FPS true
 #define SHOW_RENDERER_ERRORS true
 
+//frame clock: samples of the initial estimate, rejected samples in a row before the estimate is rebuilt
+#define FRAME_CLOCK_SEED_SAMPLES 9
+#define FRAME_CLOCK_MAX_REJECTED 30
+
 //
 //  AminoGfx
 //
@@ -32,6 +44,33 @@ AminoGfx::AminoGfx(std::string name): AminoJSEventObject(name) {
     res = pthread_mutex_init(&animLock, &attr);
     assert(res == 0);
 
+    // hitLock
+    res = pthread_mutex_init(&hitLock, NULL);
+    assert(res == 0);
+
+    // offline frames
+    res = uv_sem_init(&offlineSem, 0);
+    assert(res == 0);
+
+    res = uv_mutex_init(&videoSyncLock);
+    assert(res == 0);
+
+    res = uv_cond_init(&videoSyncCond);
+    assert(res == 0);
+
+    // text layout thread
+    res = uv_mutex_init(&layoutLock);
+    assert(res == 0);
+
+    res = uv_cond_init(&layoutCond);
+    assert(res == 0);
+
+    res = uv_cond_init(&layoutDoneCond);
+    assert(res == 0);
+
+    hitIndex = new AminoHitIndex();
+    hitIndexBack = new AminoHitIndex();
+
     //debug
     /*
     assert(pthread_mutex_lock(&animLock) == 0);
@@ -58,6 +97,21 @@ AminoGfx::~AminoGfx() {
 
     assert(res == 0);
 
+    res = pthread_mutex_destroy(&hitLock);
+    assert(res == 0);
+
+    uv_sem_destroy(&offlineSem);
+    uv_mutex_destroy(&videoSyncLock);
+    uv_cond_destroy(&videoSyncCond);
+
+    uv_mutex_destroy(&layoutLock);
+    uv_cond_destroy(&layoutCond);
+    uv_cond_destroy(&layoutDoneCond);
+
+    //hit testing
+    delete hitIndex;
+    delete hitIndexBack;
+
     //Note: properties are deleted by base class destructor
 }
 
@@ -113,6 +167,10 @@ void AminoGfx::Init(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target, AminoJSObject
 
     // group
     Nan::SetPrototypeMethod(tpl, "_setRoot", SetRoot);
+    Nan::SetPrototypeMethod(tpl, "_buildScene", BuildScene);
+    Nan::SetPrototypeMethod(tpl, "_findNodesAtXY", FindNodesAtXY);
+    Nan::SetPrototypeMethod(tpl, "_saveScene", SaveScene);
+    Nan::SetPrototypeMethod(tpl, "_loadScene", LoadScene);
     Nan::SetTemplate(tpl, "Group", AminoGroup::GetInitFunction());
 
     // primitives
@@ -124,11 +182,15 @@ void AminoGfx::Init(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target, AminoJSObject
 
     Nan::SetTemplate(tpl, "Texture", AminoTexture::GetInitFunction());
     Nan::SetTemplate(tpl, "Anim", AminoAnim::GetInitFunction());
+    Nan::SetTemplate(tpl, "Timeline", AminoTimeline::GetInitFunction());
+    Nan::SetTemplate(tpl, "AnimSet", AminoAnimSet::GetInitFunction());
 
     // animations
     Nan::SetPrototypeMethod(tpl, "clearAnimations", ClearAnimations);
-    Nan::SetPrototypeMethod(tpl, "getTime", GetTime);
+    Nan::SetPrototypeMethod(tpl, "getTime", GetClockTime);
     Nan::SetMethod(tpl, "getTime", GetTime);
+    Nan::SetPrototypeMethod(tpl, "getFrameTime", GetFrameTime);
+    Nan::SetPrototypeMethod(tpl, "_requestFrame", RequestFrame);
 
     //settings
     Nan::SetPrototypeMethod(tpl, "updatePerspective", UpdatePerspective);
@@ -273,6 +335,34 @@ void AminoGfx::initRenderer() {
                 swapInterval = swapIntervalValue->Int32Value();
             }
         }
+
+        //offline rendering
+        Nan::MaybeLocal<v8::Value> offlineMaybe = Nan::Get(obj, Nan::New<v8::String>("offline").ToLocalChecked());
+
+        if (!offlineMaybe.IsEmpty()) {
+            v8::Local<v8::Value> offlineValue = offlineMaybe.ToLocalChecked();
+
+            if (offlineValue->IsObject()) {
+                v8::Local<v8::Object> offlineObj = offlineValue->ToObject();
+                double fps = Nan::Get(offlineObj, Nan::New<v8::String>("fps").ToLocalChecked()).ToLocalChecked()->NumberValue();
+
+                if (fps > 0) {
+                    offline = true;
+                    offlineFrameDuration = 1000. / fps;
+                    virtualTime = OFFLINE_START_TIME;
+
+                    //no vsync
+                    swapInterval = 0;
+
+                    //frame callback
+                    v8::Local<v8::Value> frameValue = Nan::Get(offlineObj, Nan::New<v8::String>("frame").ToLocalChecked()).ToLocalChecked();
+
+                    if (frameValue->IsFunction()) {
+                        offlineCallback = new Nan::Callback(frameValue.As<v8::Function>());
+                    }
+                }
+            }
+        }
     }
 }
 
@@ -500,6 +590,9 @@ void AminoGfx::startRenderingThread() {
         return;
     }
 
+    //text layout (used by rendering thread)
+    startLayoutThread();
+
     int res = uv_thread_create(&thread, renderingThread, this);
 
     assert(res == 0);
@@ -555,10 +648,17 @@ void AminoGfx::stopRenderingThread() {
 
     threadRunning = false;
 
+    //wake up waiting offline frame
+    if (offlineCallback) {
+        uv_sem_post(&offlineSem);
+    }
+
     int res = uv_thread_join(&thread);
 
     assert(res == 0);
 
+    stopLayoutThread();
+
     //process remaining events
     res = uv_async_send(&asyncHandle);
 
@@ -600,18 +700,40 @@ void AminoGfx::render() {
 
     rendering = true;
 
+    //presentation time of this frame
+    frameTime = offline ? (double)virtualTime : getPresentationTime(getTime());
+
     //updates
     if (DEBUG_RENDERER) {
         printf("-> renderer: handle updates\n");
     }
 
     processAsyncQueue();
+
+    //offline: wait for the video frames of this time
+    if (offline) {
+        syncVideoPlayers();
+    }
+
     processAnimations();
 
-    //send signal to main thread to handle queues
-    int res = uv_async_send(&asyncHandle);
+    //frame callbacks (queued after the property updates of this frame)
+    if (frameRequested.exchange(false)) {
+        double *time = new double(frameTime);
 
-    assert(res == 0);
+        if (!enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoGfx::callFrame), static_cast<jsUpdateCallback>(&AminoGfx::freeFrame), time)) {
+            delete time;
+        }
+    }
+
+    //send signal to main thread to handle queues (only if needed)
+    if (needsSystemEvents() || hasPendingJSUpdates()) {
+        int res = uv_async_send(&asyncHandle);
+
+        assert(res == 0);
+    } else {
+        skippedSignals++;
+    }
 
     //update texts
     updateTextNodes();
@@ -623,6 +745,11 @@ void AminoGfx::render() {
 
     renderScene();
 
+    //offline frame readback
+    if (offlineCallback) {
+        readOfflineFrame();
+    }
+
     //done
     fpsCycleEnd = getTime();
 
@@ -631,6 +758,7 @@ void AminoGfx::render() {
     }
 
     renderingDone();
+    updateFrameClock();
     rendering = false;
 
     if (DEBUG_RENDERER) {
@@ -659,20 +787,92 @@ void AminoGfx::processAnimations() {
 
     assert(res == 0);
 
-    double currentTime = getTime();
-    int count = animations.size();
+    //added & removed animations
+    applyAnimationChanges(false);
+
+    double currentTime = frameTime;
+    double processStart = getTime();
+    std::size_t count = animations.size();
 
     //debug timer
     //printf("timer timestamp: %f\n", currentTime);
 
-    for (int i = 0; i < count; i++) {
-        animations[i]->update(currentTime);
+    //evaluate running animations
+    evaluateAnimations(animBatch, currentTime, count);
+
+    //apply
+    const int32_t *active = animBatch.active.data();
+    const float *pos = animBatch.pos.data();
+    const float *value = animBatch.value.data();
+
+    for (std::size_t i = 0; i < count; i++) {
+        AminoAnim *anim = animations[i];
+
+        if (active[i] && pos[i] >= 0 && pos[i] <= 1) {
+            //fast path
+            anim->applyBatchValue(value[i], currentTime);
+        } else {
+            //state changes
+            anim->update(currentTime);
+            anim->fillBatch(animBatch, i);
+        }
+    }
+
+    count = timelines.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        timelines[i]->update(currentTime);
+    }
+
+    count = animSets.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        animSets[i]->update(currentTime);
     }
 
+    animTime = getTime() - processStart;
+
     res = pthread_mutex_unlock(&animLock);
     assert(res == 0);
 }
 
+/**
+ * Animation kernel.
+ *
+ * Computes the position and value of all packed animations. Time functions are evaluated as polynomials without
+ * branches so the loop gets vectorized. Positions outside of [0, 1] are handled by AminoAnim::update().
+ */
+void AminoGfx::evaluateAnimations(anim_batch_t &batch, double currentTime, std::size_t count) {
+    const double *startTime = batch.startTime.data();
+    const float *invDuration = batch.invDuration.data();
+    const float *start = batch.start.data();
+    const float *end = batch.end.data();
+    const int32_t *timeFunc = batch.timeFunc.data();
+    const int32_t *reverse = batch.reverse.data();
+    float *pos = batch.pos.data();
+    float *value = batch.value.data();
+
+    for (std::size_t i = 0; i < count; i++) {
+        float p = (float)(currentTime - startTime[i]) * invDuration[i];
+        float t = std::min(std::max(p, 0.f), 1.f);
+
+        t = reverse[i] ? 1.f - t : t;
+
+        //time functions
+        float u = 1.f - t;
+        float in = t * t * t;
+        float out = 1.f - u * u * u;
+        float inOut = t < 0.5f ? 4.f * in : 1.f - 4.f * u * u * u;
+        float e = timeFunc[i] == AminoAnim::TF_CUBIC_IN ? in : t;
+
+        e = timeFunc[i] == AminoAnim::TF_CUBIC_OUT ? out : e;
+        e = timeFunc[i] == AminoAnim::TF_CUBIC_IN_OUT ? inOut : e;
+
+        pos[i] = p;
+        value[i] = start[i] + (end[i] - start[i]) * e;
+    }
+}
+
 /**
  * Clear all animations.
  *
@@ -694,226 +894,1710 @@ NAN_METHOD(AminoGfx::GetTime) {
 }
 
 /**
- * Check if rendering scene right now.
- */
-bool AminoGfx::isRendering() {
-    return rendering;
-}
-
-/**
- * Render the root node and all its children.
+ * Get the animation clock time.
+ *
+ * Note: the virtual clock in offline mode.
  */
-void AminoGfx::renderScene() {
-    if (!root) {
-        return;
-    }
-
-    if (viewportChanged) {
-        viewportChanged = false;
+NAN_METHOD(AminoGfx::GetClockTime) {
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
 
-        renderer->updateViewport(propW->value, propH->value, viewportW, viewportH);
-    }
+    assert(obj);
 
-    renderer->initScene(propR->value, propG->value, propB->value, propOpacity->value);
-    renderer->renderScene(root);
+    info.GetReturnValue().Set(obj->getClockTime());
 }
 
 /**
- * Stop rendering and free resources.
+ * Get the estimated presentation time of the current frame.
+ *
+ * Animations use this time instead of the time the frame started.
  */
-NAN_METHOD(AminoGfx::Destroy) {
+NAN_METHOD(AminoGfx::GetFrameTime) {
     AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
 
     assert(obj);
 
-    if (!obj->destroyed) {
-        obj->destroy();
+    double time = obj->frameTime;
+
+    if (time == 0) {
+        time = obj->getPresentationTime(getTime());
     }
+
+    info.GetReturnValue().Set(time);
 }
 
 /**
- * Stop rendering and free resources.
+ * Request a frame callback.
  *
- * Note: has to run on main thread.
+ * The callback is delivered once after the next rendered frame.
  */
-void AminoGfx::destroy() {
-    if (destroyed) {
-        return;
-    }
+NAN_METHOD(AminoGfx::RequestFrame) {
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
 
-    //instance
-    destroyAminoGfx();
+    assert(obj);
 
-    //base destroy
-    AminoJSEventObject::destroy();
+    obj->frameRequested = true;
 }
 
 /**
- * Stop rendering and free resources.
+ * Update the frame clock after the buffers were swapped.
  *
- * Note: has to run on main thread.
+ * Swapping blocks until the next vertical sync, so the swap timestamps follow the display refresh. The frame period is
+ * seeded with the median of several samples (the first swaps may return early) and smoothed afterwards. Outliers
+ * (skipped frames, early swaps) do not change the period; the estimate is rebuilt if all samples are rejected for a while.
+ *
+ * Note: called on rendering thread.
  */
-void AminoGfx::destroyAminoGfx() {
-    //stop thread
-    stopRenderingThread();
-
-    //bind context (to main thread)
-    if (started) {
-        started = false;
+void AminoGfx::updateFrameClock() {
+    //offline: advance virtual clock
+    if (offline) {
+        framePeriod = offlineFrameDuration;
+        offlineFrame++;
+        virtualTime = OFFLINE_START_TIME + offlineFrame * offlineFrameDuration;
+        swapTime = virtualTime.load();
+
+        //wake up video players
+        uv_mutex_lock(&videoSyncLock);
+        uv_cond_broadcast(&videoSyncCond);
+        uv_mutex_unlock(&videoSyncLock);
+        return;
+    }
 
-        bool res = bindContext();
+    double time = getTime();
+    double lastSwap = swapTime;
+    double period = framePeriod;
 
-        assert(res);
+    swapTime = time;
 
-        //renderer
-        if (renderer) {
-            delete renderer;
-            renderer = NULL;
-        }
+    if (lastSwap == 0) {
+        return;
     }
 
-    //unbind root
-    setRoot(NULL);
+    double diff = time - lastSwap;
 
-    //free async
-    clearAsyncQueue();
-    clearAnimations();
-    handleAsyncDeletes();
+    if (diff <= 0) {
+        return;
+    }
 
-    //params
-    createParams.Reset();
+    if (period == 0 || !periodSamples.empty()) {
+        //initial estimate (median)
+        periodSamples.push_back(diff);
 
-    //debug
-    if (DEBUG_BASE) {
-        printf("AminoGfx destroyed -> %i references left\n", getReferenceCount());
+        if (periodSamples.size() == FRAME_CLOCK_SEED_SAMPLES) {
+            std::nth_element(periodSamples.begin(), periodSamples.begin() + FRAME_CLOCK_SEED_SAMPLES / 2, periodSamples.end());
+            framePeriod = periodSamples[FRAME_CLOCK_SEED_SAMPLES / 2];
+            periodSamples.clear();
+            rejectedPeriods = 0;
+        }
+    } else if (diff > period * 0.5 && diff < period * 1.5) {
+        //smooth
+        framePeriod = period + (diff - period) * 0.1;
+        rejectedPeriods = 0;
+    } else if (++rejectedPeriods >= FRAME_CLOCK_MAX_REJECTED) {
+        //estimate is wrong (e.g. seeded by early swaps): rebuild (current period is used meanwhile)
+        periodSamples.push_back(diff);
     }
 }
 
 /**
- * Size has changed, update internal and JS properties.
+ * Synchronize a video player with the virtual clock (offline rendering).
  *
- * Note: has to be called after window size has changed. Does not touch the window size.
+ * The rendering thread waits until the player has shown the frame of the current time.
+ *
+ * Note: thread-safe.
  */
-void AminoGfx::updateSize(int w, int h) {
-    propW->setValue(w);
-    propH->setValue(h);
+void AminoGfx::addVideoSync(AminoVideoPlayer *player) {
+    if (!offline) {
+        return;
+    }
+
+    uv_mutex_lock(&videoSyncLock);
+    videoSyncTimes[player] = 0;
+    uv_mutex_unlock(&videoSyncLock);
 }
 
 /**
- * Position has changed, update internal and JS properties.
+ * Stop the synchronization of a video player (e.g. paused or done).
  *
- * Note: has to be called after window position has changed. Does not touch the window position.
+ * Note: thread-safe.
  */
-void AminoGfx::updatePosition(int x, int y) {
-    propX->setValue(x);
-    propY->setValue(y);
+void AminoGfx::removeVideoSync(AminoVideoPlayer *player) {
+    if (!offline) {
+        return;
+    }
+
+    uv_mutex_lock(&videoSyncLock);
+
+    if (videoSyncTimes.erase(player) > 0) {
+        uv_cond_broadcast(&videoSyncCond);
+    }
+
+    uv_mutex_unlock(&videoSyncLock);
 }
 
 /**
- * Fire runtime specific event.
+ * Wait until the virtual clock has reached a time.
  *
- * Note: has to be called on main thread!
+ * All frames before this time have been shown by the player (rendering continues).
+ *
+ * @param time milliseconds.
+ *
+ * Note: called on video player thread.
  */
-void AminoGfx::fireEvent(v8::Local<v8::Object> &evt) {
-    //event handler
-    v8::Local<v8::Object> obj = handle();
-    Nan::MaybeLocal<v8::Value> handleEventMaybe = Nan::Get(obj, Nan::New<v8::String>("handleEvent").ToLocalChecked());
+void AminoGfx::waitVideoClock(AminoVideoPlayer *player, double time, bool &stop) {
+    uv_mutex_lock(&videoSyncLock);
 
-    if (!handleEventMaybe.IsEmpty()) {
-        v8::Local<v8::Value> value = handleEventMaybe.ToLocalChecked();
-
-        if (value->IsFunction()) {
-            v8::Local<v8::Function> func = value.As<v8::Function>();
+    auto item = videoSyncTimes.find(player);
 
-            //call
-            int argc = 1;
-            v8::Local<v8::Value> argv[1] = { evt };
+    if (item != videoSyncTimes.end()) {
+        item->second = time;
+        uv_cond_broadcast(&videoSyncCond);
+    }
 
-            func->Call(obj, argc, argv);
-        }
+    while (!stop && virtualTime < time) {
+        //Note: timeout to check the stop flag
+        uv_cond_timedwait(&videoSyncCond, &videoSyncLock, 10 * 1e6);
     }
+
+    uv_mutex_unlock(&videoSyncLock);
 }
 
 /**
- * Handle sync property updates.
+ * Wait until all video players have shown the frame of the current time.
+ *
+ * Note: called on rendering thread.
  */
-bool AminoGfx::handleSyncUpdate(AnyProperty *property, void *data) {
-    //debug
-    //printf("handleSyncUpdate() %s\n", property->name.c_str());
-
-    //default: does nothing
-    bool res = AminoJSObject::handleSyncUpdate(property, data);
-
-    //size changes
-    if (property == propW || property == propH) {
-        //set new value
-        property->setAsyncData(NULL, data);
-
-        //update native window
-        updateWindowSize();
-
-        return true;
-    }
+void AminoGfx::syncVideoPlayers() {
+    uv_mutex_lock(&videoSyncLock);
 
-    //position changes
+    while (threadRunning) {
+        bool waiting = false;
 
-    if (property == propX || property == propY) {
-        property->setAsyncData(NULL, data);
-        updateWindowPosition();
+        for (auto const &item : videoSyncTimes) {
+            if (item.second <= frameTime) {
+                waiting = true;
+                break;
+            }
+        }
 
-        return true;
-    }
+        if (!waiting) {
+            break;
+        }
 
-    //title
-    if (property == propTitle) {
-        property->setAsyncData(NULL, data);
-        updateWindowTitle();
+        uv_cond_timedwait(&videoSyncCond, &videoSyncLock, 1e6);
 
-        return true;
+        //video texture initialization needs the rendering thread
+        uv_mutex_unlock(&videoSyncLock);
+        processAsyncQueue();
+        uv_mutex_lock(&videoSyncLock);
     }
 
-    return res;
+    uv_mutex_unlock(&videoSyncLock);
 }
 
-NAN_METHOD(AminoGfx::SetRoot) {
-    //new value
-    AminoGroup *group;
+/**
+ * Get the next presentation time at or after a time.
+ *
+ * Note: thread-safe. Returns the time itself until the frame clock has samples.
+ */
+double AminoGfx::getPresentationTime(double time) {
+    if (offline) {
+        return virtualTime;
+    }
 
-    if (info.Length() == 0 || info[0]->IsNull() || info[0]->IsUndefined()) {
-        group = NULL;
-    } else {
-        group = Nan::ObjectWrap::Unwrap<AminoGroup>(info[0]->ToObject());
+    double lastSwap = swapTime;
+    double period = framePeriod;
 
-        assert(group);
+    if (lastSwap == 0 || period <= 0 || time < lastSwap) {
+        return time;
     }
 
-    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
-
-    assert(obj);
+    //next vertical sync
+    double frames = std::floor((time - lastSwap) / period) + 1;
 
-    obj->setRoot(group);
+    return lastSwap + frames * period;
 }
 
 /**
- * Set the root node.
+ * Get the current clock time.
+ *
+ * Note: thread-safe. Returns the virtual time in offline mode.
  */
-void AminoGfx::setRoot(AminoGroup *group) {
-    //validate
-    if (group && !group->checkRenderer(this)) {
-        return;
+double AminoGfx::getClockTime() {
+    if (offline) {
+        return virtualTime;
     }
 
-    //free old one
-    if (root) {
+    return getTime();
+}
+
+/**
+ * Check if the virtual clock is used.
+ */
+bool AminoGfx::isOffline() {
+    return offline;
+}
+
+/**
+ * Read the rendered frame and pass it to JS.
+ *
+ * Waits until the JS callback has returned. JS changes are therefore applied to the next frame.
+ *
+ * Note: called on rendering thread.
+ */
+void AminoGfx::readOfflineFrame() {
+    offline_frame_t *frame = new offline_frame_t;
+
+    frame->w = viewportW;
+    frame->h = viewportH;
+    frame->size = viewportW * viewportH * 4;
+    frame->pixels = (char *)malloc(frame->size);
+    frame->frame = offlineFrame;
+    frame->time = virtualTime;
+
+    //RGBA, bottom-up
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, viewportW, viewportH, GL_RGBA, GL_UNSIGNED_BYTE, frame->pixels);
+
+    //call JS
+    if (!enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoGfx::callOfflineFrame), NULL, frame)) {
+        free(frame->pixels);
+        delete frame;
+        return;
+    }
+
+    int res = uv_async_send(&asyncHandle);
+
+    assert(res == 0);
+
+    uv_sem_wait(&offlineSem);
+}
+
+/**
+ * Call the offline frame callback on main thread.
+ */
+void AminoGfx::callOfflineFrame(JSCallbackUpdate *update) {
+    offline_frame_t *frame = static_cast<offline_frame_t *>(update->data);
+
+    if (offlineCallback) {
+        //create scope
+        Nan::HandleScope scope;
+
+        //frame info
+        v8::Local<v8::Object> info = Nan::New<v8::Object>();
+
+        Nan::Set(info, Nan::New("frame").ToLocalChecked(), Nan::New(frame->frame));
+        Nan::Set(info, Nan::New("time").ToLocalChecked(), Nan::New(frame->time));
+        Nan::Set(info, Nan::New("w").ToLocalChecked(), Nan::New(frame->w));
+        Nan::Set(info, Nan::New("h").ToLocalChecked(), Nan::New(frame->h));
+
+        //buffer (takes ownership of pixels)
+        v8::Local<v8::Object> buffer = Nan::NewBuffer(frame->pixels, frame->size).ToLocalChecked();
+        int argc = 2;
+        v8::Local<v8::Value> argv[] = { buffer, info };
+
+        Nan::Call(*offlineCallback, handle(), argc, argv);
+    } else {
+        free(frame->pixels);
+    }
+
+    delete frame;
+
+    //next frame
+    uv_sem_post(&offlineSem);
+}
+
+/**
+ * Call the frame callbacks on main thread.
+ *
+ * Note: all JS property updates of the frame were applied before.
+ */
+void AminoGfx::callFrame(JSCallbackUpdate *update) {
+    double *time = static_cast<double *>(update->data);
+
+    //create scope
+    Nan::HandleScope scope;
+
+    v8::Local<v8::Object> obj = handle();
+    v8::Local<v8::Value> handleFrameValue = Nan::Get(obj, Nan::New<v8::String>("_handleFrame").ToLocalChecked()).ToLocalChecked();
+
+    if (handleFrameValue->IsFunction()) {
+        v8::Local<v8::Function> handleFrameFunc = handleFrameValue.As<v8::Function>();
+        int argc = 1;
+        v8::Local<v8::Value> argv[] = { Nan::New(*time) };
+
+        Nan::Call(handleFrameFunc, obj, argc, argv);
+    }
+}
+
+/**
+ * Free the frame callback data.
+ */
+void AminoGfx::freeFrame(JSCallbackUpdate *update) {
+    delete static_cast<double *>(update->data);
+}
+
+/**
+ * Check if rendering scene right now.
+ */
+bool AminoGfx::isRendering() {
+    return rendering;
+}
+
+/**
+ * Render the root node and all its children.
+ */
+void AminoGfx::renderScene() {
+    if (!root) {
+        return;
+    }
+
+    if (viewportChanged) {
+        viewportChanged = false;
+
+        renderer->updateViewport(propW->value, propH->value, viewportW, viewportH);
+    }
+
+    //hit testing
+    bool buildHitIndex = hitTestUsed;
+
+    if (buildHitIndex) {
+        hitIndexBack->clear();
+    }
+
+    renderer->setHitIndex(buildHitIndex ? hitIndexBack:NULL);
+
+    renderer->initScene(propR->value, propG->value, propB->value, propOpacity->value);
+    renderer->renderScene(root);
+
+    if (buildHitIndex) {
+        hitIndexBack->build(propW->value, propH->value);
+
+        //swap
+        int res = pthread_mutex_lock(&hitLock);
+
+        assert(res == 0);
+
+        AminoHitIndex *tmp = hitIndex;
+
+        hitIndex = hitIndexBack;
+        hitIndexBack = tmp;
+
+        //nodes destroyed while rendering
+        for (auto node : hitRemovedNodes) {
+            hitIndex->removeNode(node);
+        }
+
+        hitRemovedNodes.clear();
+
+        res = pthread_mutex_unlock(&hitLock);
+        assert(res == 0);
+    }
+}
+
+/**
+ * Find the nodes at a position.
+ *
+ * Returns the nodes (top to bottom) and their local coordinates or undefined if the hit index is not available yet.
+ */
+NAN_METHOD(AminoGfx::FindNodesAtXY) {
+    assert(info.Length() == 2);
+
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+    GLfloat x = info[0]->NumberValue();
+    GLfloat y = info[1]->NumberValue();
+
+    assert(obj);
+
+    //query
+    std::vector<hit_result_t> results;
+    int res = pthread_mutex_lock(&obj->hitLock);
+
+    assert(res == 0);
+
+    //Note: index is built from next frame on
+    obj->hitTestUsed = true;
+
+    bool valid = obj->hitIndex->isValid();
+
+    if (valid) {
+        obj->hitIndex->findNodes(x, y, results);
+    }
+
+    res = pthread_mutex_unlock(&obj->hitLock);
+    assert(res == 0);
+
+    if (!valid) {
+        return;
+    }
+
+    //result
+    std::size_t count = results.size();
+    v8::Local<v8::Object> resObj = Nan::New<v8::Object>();
+    v8::Local<v8::Array> nodes = Nan::New<v8::Array>(count);
+    v8::Local<v8::Array> coords = Nan::New<v8::Array>(count * 2);
+
+    for (std::size_t i = 0; i < count; i++) {
+        hit_result_t &item = results[i];
+
+        Nan::Set(nodes, i, item.node->handle());
+        Nan::Set(coords, i * 2, Nan::New<v8::Number>(item.x));
+        Nan::Set(coords, i * 2 + 1, Nan::New<v8::Number>(item.y));
+    }
+
+    Nan::Set(resObj, Nan::New("nodes").ToLocalChecked(), nodes);
+    Nan::Set(resObj, Nan::New("coords").ToLocalChecked(), coords);
+
+    info.GetReturnValue().Set(resObj);
+}
+
+/**
+ * Remove a node from the hit index.
+ *
+ * Note: called if a node is destroyed.
+ */
+void AminoGfx::removeFromHitIndex(AminoNode *node) {
+    int res = pthread_mutex_lock(&hitLock);
+
+    assert(res == 0);
+
+    hitIndex->removeNode(node);
+
+    //index built in the current frame
+    if (hitTestUsed) {
+        hitRemovedNodes.push_back(node);
+    }
+
+    res = pthread_mutex_unlock(&hitLock);
+    assert(res == 0);
+}
+
+/**
+ * Stop rendering and free resources.
+ */
+NAN_METHOD(AminoGfx::Destroy) {
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+
+    assert(obj);
+
+    if (!obj->destroyed) {
+        obj->destroy();
+    }
+}
+
+/**
+ * Stop rendering and free resources.
+ *
+ * Note: has to run on main thread.
+ */
+void AminoGfx::destroy() {
+    if (destroyed) {
+        return;
+    }
+
+    //instance
+    destroyAminoGfx();
+
+    //base destroy
+    AminoJSEventObject::destroy();
+}
+
+/**
+ * Stop rendering and free resources.
+ *
+ * Note: has to run on main thread.
+ */
+void AminoGfx::destroyAminoGfx() {
+    //stop thread
+    stopRenderingThread();
+
+    //bind context (to main thread)
+    if (started) {
+        started = false;
+
+        bool res = bindContext();
+
+        assert(res);
+
+        //renderer
+        if (renderer) {
+            delete renderer;
+            renderer = NULL;
+        }
+    }
+
+    //unbind root
+    setRoot(NULL);
+
+    //free async
+    clearAsyncQueue();
+    clearAnimations();
+    handleAsyncDeletes();
+
+    //params
+    createParams.Reset();
+
+    if (offlineCallback) {
+        delete offlineCallback;
+        offlineCallback = NULL;
+    }
+
+    //debug
+    if (DEBUG_BASE) {
+        printf("AminoGfx destroyed -> %i references left\n", getReferenceCount());
+    }
+}
+
+/**
+ * Size has changed, update internal and JS properties.
+ *
+ * Note: has to be called after window size has changed. Does not touch the window size.
+ */
+void AminoGfx::updateSize(int w, int h) {
+    propW->setValue(w);
+    propH->setValue(h);
+}
+
+/**
+ * Position has changed, update internal and JS properties.
+ *
+ * Note: has to be called after window position has changed. Does not touch the window position.
+ */
+void AminoGfx::updatePosition(int x, int y) {
+    propX->setValue(x);
+    propY->setValue(y);
+}
+
+/**
+ * Fire runtime specific event.
+ *
+ * Note: has to be called on main thread!
+ */
+void AminoGfx::fireEvent(v8::Local<v8::Object> &evt) {
+    //event handler
+    v8::Local<v8::Object> obj = handle();
+    Nan::MaybeLocal<v8::Value> handleEventMaybe = Nan::Get(obj, Nan::New<v8::String>("handleEvent").ToLocalChecked());
+
+    if (!handleEventMaybe.IsEmpty()) {
+        v8::Local<v8::Value> value = handleEventMaybe.ToLocalChecked();
+
+        if (value->IsFunction()) {
+            v8::Local<v8::Function> func = value.As<v8::Function>();
+
+            //call
+            int argc = 1;
+            v8::Local<v8::Value> argv[1] = { evt };
+
+            func->Call(obj, argc, argv);
+        }
+    }
+}
+
+/**
+ * Handle sync property updates.
+ */
+bool AminoGfx::handleSyncUpdate(AnyProperty *property, void *data) {
+    //debug
+    //printf("handleSyncUpdate() %s\n", property->name.c_str());
+
+    //default: does nothing
+    bool res = AminoJSObject::handleSyncUpdate(property, data);
+
+    //size changes
+    if (property == propW || property == propH) {
+        //set new value
+        property->setAsyncData(NULL, data);
+
+        //update native window
+        updateWindowSize();
+
+        return true;
+    }
+
+    //position changes
+
+    if (property == propX || property == propY) {
+        property->setAsyncData(NULL, data);
+        updateWindowPosition();
+
+        return true;
+    }
+
+    //title
+    if (property == propTitle) {
+        property->setAsyncData(NULL, data);
+        updateWindowTitle();
+
+        return true;
+    }
+
+    return res;
+}
+
+NAN_METHOD(AminoGfx::SetRoot) {
+    //new value
+    AminoGroup *group;
+
+    if (info.Length() == 0 || info[0]->IsNull() || info[0]->IsUndefined()) {
+        group = NULL;
+    } else {
+        group = Nan::ObjectWrap::Unwrap<AminoGroup>(info[0]->ToObject());
+
+        assert(group);
+    }
+
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+
+    assert(obj);
+
+    obj->setRoot(group);
+}
+
+/**
+ * Set the root node.
+ */
+void AminoGfx::setRoot(AminoGroup *group) {
+    //validate
+    if (group && !group->checkRenderer(this)) {
+        return;
+    }
+
+    //free old one
+    if (root) {
         root->release();
     }
 
-    //set
-    root = group;
+    //set
+    root = group;
+
+    if (group) {
+        group->retain();
+    }
+}
+
+/**
+ * Build a node tree from a description.
+ *
+ * Note: all native property values and children are applied in a single async update.
+ */
+NAN_METHOD(AminoGfx::BuildScene) {
+    assert(info.Length() == 2);
+
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+    v8::Local<v8::Object> types = info[1]->ToObject();
+
+    assert(obj);
+
+    if (!info[0]->IsObject()) {
+        Nan::ThrowTypeError("invalid scene description");
+        return;
+    }
+
+    v8::Local<v8::Object> desc = info[0]->ToObject();
+
+    //create nodes
+    scene_build_t *scene = new scene_build_t();
+    v8::Local<v8::Object> root;
+
+    if (!obj->buildSceneNode(desc, types, scene, root)) {
+        //exception thrown
+        obj->freeScene(scene);
+        return;
+    }
+
+    obj->applyScene(root, scene);
+
+    info.GetReturnValue().Set(root);
+}
+
+/**
+ * Create a scene node and its children.
+ *
+ * Note: has to be called on main thread.
+ */
+bool AminoGfx::buildSceneNode(v8::Local<v8::Object> &desc, v8::Local<v8::Object> &types, scene_build_t *scene, v8::Local<v8::Object> &res) {
+    //type
+    v8::Local<v8::Value> typeValue = Nan::Get(desc, Nan::New("type").ToLocalChecked()).ToLocalChecked();
+
+    if (!typeValue->IsString()) {
+        Nan::ThrowTypeError("missing node type");
+        return false;
+    }
+
+    v8::Local<v8::Object> jsNode;
+
+    if (!createSceneNode(AminoJSObject::toString(typeValue), types, jsNode)) {
+        return false;
+    }
+
+    //properties
+    v8::Local<v8::Array> keys = Nan::GetOwnPropertyNames(desc).ToLocalChecked();
+    uint32_t keyCount = keys->Length();
+    bool nativeValues = false;
+
+    for (uint32_t i = 0; i < keyCount; i++) {
+        v8::Local<v8::Value> keyValue = Nan::Get(keys, i).ToLocalChecked();
+        std::string key = AminoJSObject::toString(keyValue);
+
+        if (key == "type" || key == "children") {
+            continue;
+        }
+
+        if (!setSceneAttribute(jsNode, key, Nan::Get(desc, keyValue).ToLocalChecked(), scene, nativeValues)) {
+            return false;
+        }
+    }
+
+    if (nativeValues) {
+        markSceneNode(jsNode);
+    }
+
+    //children
+    v8::Local<v8::Value> childrenValue = Nan::Get(desc, Nan::New("children").ToLocalChecked()).ToLocalChecked();
+
+    if (!childrenValue->IsUndefined()) {
+        if (!childrenValue->IsArray()) {
+            Nan::ThrowTypeError("invalid children");
+            return false;
+        }
+
+        v8::Local<v8::Array> children = childrenValue.As<v8::Array>();
+        uint32_t childCount = children->Length();
+        v8::Local<v8::Array> jsChildren = Nan::New<v8::Array>();
+
+        for (uint32_t i = 0; i < childCount; i++) {
+            v8::Local<v8::Value> childValue = Nan::Get(children, i).ToLocalChecked();
+
+            if (!childValue->IsObject() || childValue->IsArray()) {
+                Nan::ThrowTypeError("invalid scene node");
+                return false;
+            }
+
+            v8::Local<v8::Object> childDesc = childValue->ToObject();
+            v8::Local<v8::Object> jsChild;
+
+            if (!buildSceneNode(childDesc, types, scene, jsChild) || !addSceneChild(jsNode, jsChildren, jsChild, scene)) {
+                return false;
+            }
+        }
+    }
+
+    res = jsNode;
+
+    return true;
+}
+
+/**
+ * Create a scene node instance.
+ *
+ * @param type key in types object.
+ */
+bool AminoGfx::createSceneNode(const std::string &type, v8::Local<v8::Object> &types, v8::Local<v8::Object> &res) {
+    Nan::MaybeLocal<v8::Value> ctorMaybe = Nan::Get(types, Nan::New<v8::String>(type).ToLocalChecked());
+
+    if (ctorMaybe.IsEmpty() || !ctorMaybe.ToLocalChecked()->IsFunction()) {
+        std::string msg = "unknown node type: " + type;
+
+        Nan::ThrowTypeError(msg.c_str());
+        return false;
+    }
+
+    //create instance
+    v8::Local<v8::Function> ctor = ctorMaybe.ToLocalChecked().As<v8::Function>();
+    v8::Local<v8::Value> argv[] = { handle() };
+    Nan::MaybeLocal<v8::Object> nodeMaybe = Nan::NewInstance(ctor, 1, argv);
+
+    if (nodeMaybe.IsEmpty()) {
+        //exception in constructor
+        return false;
+    }
+
+    res = nodeMaybe.ToLocalChecked();
+
+    return true;
+}
+
+/**
+ * Set a scene node attribute.
+ *
+ * Native properties without listeners are set directly (JS value read on first access). Other properties
+ * use the JS setter, native values are collected in the scene.
+ *
+ * @param nativeValue set to true if the JS value was not updated.
+ */
+bool AminoGfx::setSceneAttribute(v8::Local<v8::Object> &jsNode, const std::string &key, v8::Local<v8::Value> value, scene_build_t *scene, bool &nativeValue) {
+    AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(jsNode);
+
+    assert(node);
+
+    AnyProperty *prop = node->getPropertyWithName(key);
+
+    if (prop && prop->connected && !prop->watched && !value->IsNull() && !value->IsUndefined() && !value->IsArray()) {
+        bool valid = false;
+        void *data = prop->getAsyncData(value, valid);
+
+        if (valid) {
+            setSceneProperty(prop, data, scene);
+            nativeValue = true;
+
+            return true;
+        }
+    }
+
+    //JS property
+    Nan::MaybeLocal<v8::Value> propMaybe = Nan::Get(jsNode, Nan::New<v8::String>(key).ToLocalChecked());
+
+    if (propMaybe.IsEmpty() || !propMaybe.ToLocalChecked()->IsFunction()) {
+        std::string msg = "unknown attribute: " + key;
+
+        Nan::ThrowError(msg.c_str());
+        return false;
+    }
+
+    v8::Local<v8::Function> propFunc = propMaybe.ToLocalChecked().As<v8::Function>();
+
+    if (!prop || !prop->connected) {
+        //JS property
+        v8::Local<v8::Value> argv[] = { value };
+
+        return !Nan::Call(propFunc, jsNode, 1, argv).IsEmpty();
+    }
+
+    //check readonly
+    if (Nan::Get(propFunc, Nan::New("readonly").ToLocalChecked()).ToLocalChecked()->BooleanValue()) {
+        return true;
+    }
+
+    //JS setter (listeners, no native update)
+    v8::Local<v8::Value> argv[] = { value, Nan::True() };
+
+    if (Nan::Call(propFunc, jsNode, 2, argv).IsEmpty()) {
+        //exception in listener
+        return false;
+    }
+
+    //native value (batched)
+    bool valid = false;
+    void *data = prop->getAsyncData(value, valid);
+
+    if (valid) {
+        scene->updates.push_back(new AsyncPropertyUpdate(prop, data));
+
+        if (prop->jsStale) {
+            //transferred (typed arrays)
+            Nan::Set(propFunc, Nan::New("stale").ToLocalChecked(), Nan::True());
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Set a native property value of a scene node.
+ *
+ * The value is visible to the JS getter right away (node not rendered yet), the renderer gets the update with
+ * the scene.
+ *
+ * Note: takes ownership of data.
+ */
+void AminoGfx::setSceneProperty(AnyProperty *prop, void *data, scene_build_t *scene) {
+    prop->setAsyncData(NULL, data);
+    prop->jsStale = true;
+
+    scene->updates.push_back(new AsyncPropertyUpdate(prop, data));
+}
+
+/**
+ * Mark a node with native scene values (JS properties read them on first access).
+ */
+void AminoGfx::markSceneNode(v8::Local<v8::Object> &jsNode) {
+    Nan::Set(jsNode, Nan::New("_sceneProps").ToLocalChecked(), Nan::True());
+}
+
+/**
+ * Add a child to a scene group.
+ */
+bool AminoGfx::addSceneChild(v8::Local<v8::Object> &jsGroup, v8::Local<v8::Array> &jsChildren, v8::Local<v8::Object> &jsChild, scene_build_t *scene) {
+    AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(jsGroup);
+
+    assert(node);
+
+    if (node->type != GROUP) {
+        Nan::ThrowTypeError("children not supported");
+        return false;
+    }
+
+    //JS
+    if (jsChildren->Length() == 0) {
+        Nan::Set(jsGroup, Nan::New("children").ToLocalChecked(), jsChildren);
+    }
+
+    uint32_t pos = jsChildren->Length();
+
+    Nan::Set(jsChild, Nan::New("parent").ToLocalChecked(), jsGroup);
+    Nan::Set(jsChild, Nan::New("_childIndex").ToLocalChecked(), Nan::New(pos));
+    Nan::Set(jsChildren, pos, jsChild);
+
+    //native (Note: reference kept on JS side)
+    scene->children.push_back(std::make_pair(static_cast<AminoGroup *>(node), Nan::ObjectWrap::Unwrap<AminoNode>(jsChild)));
+
+    return true;
+}
+
+/**
+ * Apply a scene on the rendering thread.
+ */
+void AminoGfx::applyScene(v8::Local<v8::Object> &root, scene_build_t *scene) {
+    v8::Local<v8::Value> rootValue = root;
+
+    enqueueValueUpdate(rootValue, scene, static_cast<asyncValueCallback>(&AminoGfx::buildSceneHandler));
+}
+
+/**
+ * Free a scene which was not applied.
+ */
+void AminoGfx::freeScene(scene_build_t *scene) {
+    for (std::size_t i = 0; i < scene->updates.size(); i++) {
+        delete scene->updates[i];
+    }
+
+    delete scene;
+}
+
+/**
+ * Apply a scene build.
+ */
+void AminoGfx::buildSceneHandler(AsyncValueUpdate *update, int state) {
+    scene_build_t *scene = (scene_build_t *)update->data;
+
+    if (state == AsyncValueUpdate::STATE_APPLY) {
+        //properties
+        std::size_t count = scene->updates.size();
+
+        for (std::size_t i = 0; i < count; i++) {
+            AsyncPropertyUpdate *item = scene->updates[i];
+
+            item->property->obj->handleAsyncUpdate(item);
+        }
+
+        //children
+        count = scene->children.size();
+
+        for (std::size_t i = 0; i < count; i++) {
+            scene->children[i].first->appendChild(scene->children[i].second);
+        }
+    } else if (state == AsyncValueUpdate::STATE_DELETE) {
+        //on main thread
+        freeScene(scene);
+        update->data = NULL;
+    }
+}
+
+//scene snapshot format (Note: native byte order)
+#define SCENE_MAGIC   0x43534D41 //"AMSC"
+#define SCENE_VERSION 1
+
+#define SCENE_VALUE_NUMBER       1
+#define SCENE_VALUE_BOOLEAN      2
+#define SCENE_VALUE_STRING       3
+#define SCENE_VALUE_ARRAY        4
+#define SCENE_VALUE_FLOAT_ARRAY  5
+#define SCENE_VALUE_USHORT_ARRAY 6
+
+/**
+ * Append raw data to a snapshot.
+ */
+static void sceneWrite(std::string &out, const void *data, std::size_t size) {
+    out.append((const char *)data, size);
+}
+
+/**
+ * Append an integer to a snapshot.
+ */
+static void sceneWriteUInt32(std::string &out, uint32_t value) {
+    sceneWrite(out, &value, sizeof(uint32_t));
+}
+
+/**
+ * Append a string to a snapshot.
+ */
+static void sceneWriteString(std::string &out, const std::string &str) {
+    sceneWriteUInt32(out, str.size());
+    sceneWrite(out, str.c_str(), str.size());
+}
+
+/**
+ * Append a JS property value to a snapshot.
+ *
+ * @return false if the value type is not supported.
+ */
+static bool sceneWriteValue(std::string &out, const std::string &name, v8::Local<v8::Value> value) {
+    uint8_t type;
+
+    if (value->IsNumber()) {
+        double num = value->NumberValue();
+
+        type = SCENE_VALUE_NUMBER;
+        sceneWriteString(out, name);
+        sceneWrite(out, &type, 1);
+        sceneWrite(out, &num, sizeof(double));
+
+        return true;
+    }
+
+    if (value->IsBoolean()) {
+        uint8_t b = value->BooleanValue() ? 1:0;
+
+        type = SCENE_VALUE_BOOLEAN;
+        sceneWriteString(out, name);
+        sceneWrite(out, &type, 1);
+        sceneWrite(out, &b, 1);
+
+        return true;
+    }
+
+    if (value->IsString()) {
+        Nan::Utf8String str(value);
+
+        type = SCENE_VALUE_STRING;
+        sceneWriteString(out, name);
+        sceneWrite(out, &type, 1);
+        sceneWriteString(out, std::string(*str, str.length()));
+
+        return true;
+    }
+
+    if (value->IsFloat32Array() || value->IsUint16Array()) {
+        v8::Local<v8::ArrayBufferView> view = value.As<v8::ArrayBufferView>();
+        v8::ArrayBuffer::Contents contents = view->Buffer()->GetContents();
+
+        type = value->IsFloat32Array() ? SCENE_VALUE_FLOAT_ARRAY:SCENE_VALUE_USHORT_ARRAY;
+        sceneWriteString(out, name);
+        sceneWrite(out, &type, 1);
+        sceneWriteUInt32(out, view->ByteLength());
+        sceneWrite(out, (char *)contents.Data() + view->ByteOffset(), view->ByteLength());
+
+        return true;
+    }
+
+    if (value->IsArray()) {
+        //numbers only
+        v8::Local<v8::Array> arr = value.As<v8::Array>();
+        uint32_t count = arr->Length();
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (!arr->Get(i)->IsNumber()) {
+                return false;
+            }
+        }
+
+        type = SCENE_VALUE_ARRAY;
+        sceneWriteString(out, name);
+        sceneWrite(out, &type, 1);
+        sceneWriteUInt32(out, count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            double num = arr->Get(i)->NumberValue();
+
+            sceneWrite(out, &num, sizeof(double));
+        }
+
+        return true;
+    }
+
+    //not supported (e.g. objects)
+    return false;
+}
+
+/**
+ * Save a node tree to a binary snapshot.
+ *
+ * Stores the node types, all property values and the children. Textures are stored by their source (error if not loaded from a source).
+ */
+NAN_METHOD(AminoGfx::SaveScene) {
+    assert(info.Length() == 2);
+
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+    v8::Local<v8::Object> root = info[0]->ToObject();
+    v8::Local<v8::Object> types = info[1]->ToObject();
+
+    assert(obj);
+
+    std::string out;
+
+    sceneWriteUInt32(out, SCENE_MAGIC);
+    sceneWriteUInt32(out, SCENE_VERSION);
+
+    if (!obj->saveSceneNode(out, root, types)) {
+        //exception thrown
+        return;
+    }
+
+    info.GetReturnValue().Set(Nan::CopyBuffer(out.c_str(), out.size()).ToLocalChecked());
+}
+
+/**
+ * Save a scene node and its children.
+ */
+bool AminoGfx::saveSceneNode(std::string &out, v8::Local<v8::Object> &jsNode, v8::Local<v8::Object> &types) {
+    //type
+    v8::Local<v8::Value> ctor = Nan::Get(jsNode, Nan::New("constructor").ToLocalChecked()).ToLocalChecked();
+    v8::Local<v8::Array> typeNames = Nan::GetOwnPropertyNames(types).ToLocalChecked();
+    std::string type;
+
+    for (uint32_t i = 0; i < typeNames->Length(); i++) {
+        v8::Local<v8::Value> typeName = typeNames->Get(i);
+
+        if (Nan::Get(types, typeName).ToLocalChecked()->StrictEquals(ctor)) {
+            Nan::Utf8String str(typeName);
+
+            type = *str;
+            break;
+        }
+    }
+
+    if (type.empty()) {
+        Nan::ThrowTypeError("unknown node type");
+        return false;
+    }
+
+    sceneWriteString(out, type);
+
+    //properties
+    AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(jsNode);
+
+    assert(node);
+
+    v8::Local<v8::Array> names = Nan::GetOwnPropertyNames(jsNode).ToLocalChecked();
+    std::size_t countPos = out.size();
+    uint32_t count = 0;
+
+    //textures loaded from a source (restored by the source)
+    bool hasSource = false;
+    v8::Local<v8::Value> srcProp = Nan::Get(jsNode, Nan::New("src").ToLocalChecked()).ToLocalChecked();
+
+    if (srcProp->IsFunction()) {
+        hasSource = Nan::Get(srcProp.As<v8::Object>(), Nan::New("value").ToLocalChecked()).ToLocalChecked()->IsString();
+    }
+
+    sceneWriteUInt32(out, 0);
+
+    for (uint32_t i = 0; i < names->Length(); i++) {
+        v8::Local<v8::Value> nameValue = names->Get(i);
+        v8::Local<v8::Value> propValue = Nan::Get(jsNode, nameValue).ToLocalChecked();
+
+        if (!propValue->IsFunction()) {
+            continue;
+        }
+
+        //property function
+        v8::Local<v8::Function> propFunc = propValue.As<v8::Function>();
+        Nan::Utf8String funcName(propFunc->GetName());
+
+        if (strcmp(*funcName, "AminoProperty") != 0) {
+            continue;
+        }
+
+        if (Nan::Get(propFunc, Nan::New("readonly").ToLocalChecked()).ToLocalChecked()->BooleanValue()) {
+            continue;
+        }
+
+        //value
+        Nan::Utf8String name(nameValue);
+        std::string nameStr(*name);
+        v8::Local<v8::Value> value;
+        AnyProperty *prop = node->getPropertyWithName(nameStr);
+
+        if (prop && prop->jsStale) {
+            //skipped by animation
+            value = prop->toValue();
+        } else {
+            value = Nan::Get(propFunc, Nan::New("value").ToLocalChecked()).ToLocalChecked();
+        }
+
+        if (value->IsNull() || value->IsUndefined()) {
+            //default value
+            continue;
+        }
+
+        if (hasSource && (nameStr == "image" || nameStr == "texture")) {
+            //loaded from src
+            continue;
+        }
+
+        if (node->type == TEXT && nameStr == "font") {
+            //loaded from the font properties
+            continue;
+        }
+
+        if (!sceneWriteValue(out, nameStr, value)) {
+            std::string msg = "cannot save property: " + nameStr;
+
+            Nan::ThrowTypeError(msg.c_str());
+            return false;
+        }
+
+        count++;
+    }
+
+    memcpy(&out[countPos], &count, sizeof(uint32_t));
+
+    //children
+    v8::Local<v8::Array> jsChildren;
+
+    if (node->type == GROUP) {
+        v8::Local<v8::Value> childrenValue = Nan::Get(jsNode, Nan::New("children").ToLocalChecked()).ToLocalChecked();
+
+        if (childrenValue->IsArray()) {
+            jsChildren = childrenValue.As<v8::Array>();
+        }
+    }
+
+    count = jsChildren.IsEmpty() ? 0:jsChildren->Length();
+    sceneWriteUInt32(out, count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        v8::Local<v8::Object> jsChild = jsChildren->Get(i)->ToObject();
+
+        if (!saveSceneNode(out, jsChild, types)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Read raw data from a snapshot.
+ */
+static bool sceneRead(AminoGfx::scene_reader_t *reader, void *data, std::size_t size) {
+    //Note: no overflow (pos <= size)
+    if (size > reader->size - reader->pos) {
+        return false;
+    }
+
+    memcpy(data, reader->data + reader->pos, size);
+    reader->pos += size;
+
+    return true;
+}
+
+/**
+ * Read an integer from a snapshot.
+ */
+static bool sceneReadUInt32(AminoGfx::scene_reader_t *reader, uint32_t &value) {
+    return sceneRead(reader, &value, sizeof(uint32_t));
+}
+
+/**
+ * Read a string from a snapshot.
+ */
+static bool sceneReadString(AminoGfx::scene_reader_t *reader, std::string &str) {
+    uint32_t len;
+
+    if (!sceneReadUInt32(reader, len) || len > reader->size - reader->pos) {
+        return false;
+    }
+
+    str.assign(reader->data + reader->pos, len);
+    reader->pos += len;
+
+    return true;
+}
+
+/**
+ * Read a property value from a snapshot.
+ */
+static bool sceneReadValue(AminoGfx::scene_reader_t *reader, v8::Local<v8::Value> &value) {
+    uint8_t type;
+
+    if (!sceneRead(reader, &type, 1)) {
+        return false;
+    }
+
+    switch (type) {
+        case SCENE_VALUE_NUMBER:
+            {
+                double num;
+
+                if (!sceneRead(reader, &num, sizeof(double))) {
+                    return false;
+                }
+
+                value = Nan::New<v8::Number>(num);
+                return true;
+            }
+
+        case SCENE_VALUE_BOOLEAN:
+            {
+                uint8_t b;
+
+                if (!sceneRead(reader, &b, 1)) {
+                    return false;
+                }
+
+                value = Nan::New<v8::Boolean>(b != 0);
+                return true;
+            }
+
+        case SCENE_VALUE_STRING:
+            {
+                std::string str;
+
+                if (!sceneReadString(reader, str)) {
+                    return false;
+                }
+
+                value = Nan::New<v8::String>(str).ToLocalChecked();
+                return true;
+            }
+
+        case SCENE_VALUE_ARRAY:
+            {
+                uint32_t count;
+
+                if (!sceneReadUInt32(reader, count) || count > (reader->size - reader->pos) / sizeof(double)) {
+                    return false;
+                }
+
+                v8::Local<v8::Array> arr = Nan::New<v8::Array>(count);
+
+                for (uint32_t i = 0; i < count; i++) {
+                    double num;
+
+                    sceneRead(reader, &num, sizeof(double));
+                    Nan::Set(arr, i, Nan::New<v8::Number>(num));
+                }
+
+                value = arr;
+                return true;
+            }
+
+        case SCENE_VALUE_FLOAT_ARRAY:
+        case SCENE_VALUE_USHORT_ARRAY:
+            {
+                uint32_t size;
+
+                if (!sceneReadUInt32(reader, size) || size > reader->size - reader->pos) {
+                    return false;
+                }
+
+                //copy (snapshot data is released after loading)
+                v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), size);
+
+                sceneRead(reader, buffer->GetContents().Data(), size);
+
+                if (type == SCENE_VALUE_FLOAT_ARRAY) {
+                    value = v8::Float32Array::New(buffer, 0, size / sizeof(float));
+                } else {
+                    value = v8::Uint16Array::New(buffer, 0, size / sizeof(ushort));
+                }
+
+                return true;
+            }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Convert a snapshot number to an integer (JS ToInt32 semantics).
+ */
+static int32_t sceneToInt32(double num) {
+    if (!std::isfinite(num)) {
+        return 0;
+    }
+
+    return (int32_t)(uint32_t)(int64_t)std::fmod(std::trunc(num), 4294967296.0);
+}
+
+/**
+ * Read a property value from a snapshot as native data (no JS value).
+ *
+ * Note: data is NULL if the value does not match the property type (reader position unchanged).
+ */
+static bool sceneReadPropertyData(AminoGfx::scene_reader_t *reader, AminoJSObject::AnyProperty *prop, void *&data) {
+    std::size_t start = reader->pos;
+    uint8_t type;
+
+    data = NULL;
+
+    if (!sceneRead(reader, &type, 1)) {
+        return false;
+    }
+
+    switch (type) {
+        case SCENE_VALUE_NUMBER:
+            {
+                double num;
+
+                if (!sceneRead(reader, &num, sizeof(double))) {
+                    return false;
+                }
+
+                if (prop->type == AminoJSObject::PROPERTY_FLOAT) {
+                    data = new float(num);
+                } else if (prop->type == AminoJSObject::PROPERTY_INT32) {
+                    data = new int(sceneToInt32(num));
+                } else if (prop->type == AminoJSObject::PROPERTY_UINT32) {
+                    data = new unsigned int((uint32_t)sceneToInt32(num));
+                }
+                break;
+            }
+
+        case SCENE_VALUE_BOOLEAN:
+            {
+                uint8_t b;
+
+                if (!sceneRead(reader, &b, 1)) {
+                    return false;
+                }
+
+                if (prop->type == AminoJSObject::PROPERTY_BOOLEAN) {
+                    data = new bool(b != 0);
+                }
+                break;
+            }
+
+        case SCENE_VALUE_STRING:
+            {
+                if (prop->type != AminoJSObject::PROPERTY_UTF8) {
+                    break;
+                }
+
+                std::string *str = new std::string();
+
+                if (!sceneReadString(reader, *str)) {
+                    delete str;
+                    return false;
+                }
+
+                data = str;
+                break;
+            }
+
+        case SCENE_VALUE_FLOAT_ARRAY:
+        case SCENE_VALUE_USHORT_ARRAY:
+            {
+                bool isFloat = type == SCENE_VALUE_FLOAT_ARRAY;
+                std::size_t elementSize = isFloat ? sizeof(float):sizeof(ushort);
+                uint32_t size;
+
+                if (prop->type != (isFloat ? AminoJSObject::PROPERTY_FLOAT_ARRAY:AminoJSObject::PROPERTY_USHORT_ARRAY)) {
+                    break;
+                }
+
+                if (!sceneReadUInt32(reader, size) || size > reader->size - reader->pos || size % elementSize != 0) {
+                    return false;
+                }
+
+                //copy (snapshot data is released after loading)
+                AminoJSObject::TypedArrayData *arr = new AminoJSObject::TypedArrayData(size / elementSize, elementSize);
+
+                if (arr->length * elementSize != size) {
+                    //out of memory
+                    delete arr;
+                    break;
+                }
+
+                if (size > 0) {
+                    sceneRead(reader, arr->data, size);
+                }
+
+                data = arr;
+                break;
+            }
+
+        default:
+            break;
+    }
+
+    if (!data) {
+        //JS value
+        reader->pos = start;
+    }
 
-    if (group) {
-        group->retain();
+    return true;
+}
+
+/**
+ * Load a node tree from a binary snapshot.
+ *
+ * The snapshot is either a buffer or a file path. Files are memory mapped.
+ *
+ * Note: all native property values and children are applied in a single async update.
+ */
+NAN_METHOD(AminoGfx::LoadScene) {
+    assert(info.Length() == 2);
+
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+    v8::Local<v8::Object> types = info[1]->ToObject();
+
+    assert(obj);
+
+    //data
+    scene_reader_t reader;
+    void *map = NULL;
+    std::size_t mapSize = 0;
+
+    if (info[0]->IsString()) {
+        //memory map file
+        Nan::Utf8String path(info[0]);
+        int fd = open(*path, O_RDONLY);
+        struct stat st;
+
+        if (fd == -1 || fstat(fd, &st) == -1) {
+            if (fd != -1) {
+                close(fd);
+            }
+
+            std::string msg = "could not open snapshot: " + std::string(*path);
+
+            Nan::ThrowError(msg.c_str());
+            return;
+        }
+
+        mapSize = st.st_size;
+
+        if (mapSize > 0) {
+            map = mmap(NULL, mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        close(fd);
+
+        if (map == MAP_FAILED || !map) {
+            Nan::ThrowError("could not map snapshot");
+            return;
+        }
+
+        reader.data = (const char *)map;
+        reader.size = mapSize;
+    } else if (node::Buffer::HasInstance(info[0])) {
+        v8::Local<v8::Object> bufferObj = info[0]->ToObject();
+
+        reader.data = node::Buffer::Data(bufferObj);
+        reader.size = node::Buffer::Length(bufferObj);
+    } else {
+        Nan::ThrowTypeError("invalid snapshot");
+        return;
+    }
+
+    reader.pos = 0;
+
+    //header
+    uint32_t magic, version;
+    bool res = sceneReadUInt32(&reader, magic) && magic == SCENE_MAGIC && sceneReadUInt32(&reader, version) && version == SCENE_VERSION;
+    scene_build_t *scene = new scene_build_t();
+    v8::Local<v8::Object> root;
+
+    if (!res) {
+        Nan::ThrowError("invalid snapshot");
+    } else {
+        res = obj->loadSceneNode(&reader, types, scene, root);
+    }
+
+    if (map) {
+        munmap(map, mapSize);
+    }
+
+    if (!res) {
+        //exception thrown
+        obj->freeScene(scene);
+        return;
+    }
+
+    obj->applyScene(root, scene);
+
+    info.GetReturnValue().Set(root);
+}
+
+/**
+ * Load a scene node and its children.
+ */
+bool AminoGfx::loadSceneNode(scene_reader_t *reader, v8::Local<v8::Object> &types, scene_build_t *scene, v8::Local<v8::Object> &res) {
+    //type
+    std::string type;
+    uint32_t count;
+    v8::Local<v8::Object> jsNode;
+
+    if (!sceneReadString(reader, type) || !sceneReadUInt32(reader, count)) {
+        Nan::ThrowError("invalid snapshot");
+        return false;
+    }
+
+    if (!createSceneNode(type, types, jsNode)) {
+        return false;
+    }
+
+    //properties
+    bool nativeValues = false;
+
+    AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(jsNode);
+
+    assert(node);
+
+    for (uint32_t i = 0; i < count; i++) {
+        std::string name;
+
+        if (!sceneReadString(reader, name)) {
+            Nan::ThrowError("invalid snapshot");
+            return false;
+        }
+
+        //native value (decoded without JS value)
+        AnyProperty *prop = node->getPropertyWithName(name);
+
+        if (prop && prop->connected && !prop->watched) {
+            void *data;
+
+            if (!sceneReadPropertyData(reader, prop, data)) {
+                Nan::ThrowError("invalid snapshot");
+                return false;
+            }
+
+            if (data) {
+                setSceneProperty(prop, data, scene);
+                nativeValues = true;
+                continue;
+            }
+        }
+
+        //JS value
+        v8::Local<v8::Value> value;
+
+        if (!sceneReadValue(reader, value)) {
+            Nan::ThrowError("invalid snapshot");
+            return false;
+        }
+
+        if (!setSceneAttribute(jsNode, name, value, scene, nativeValues)) {
+            return false;
+        }
+    }
+
+    if (nativeValues) {
+        markSceneNode(jsNode);
+    }
+
+    //children
+    if (!sceneReadUInt32(reader, count)) {
+        Nan::ThrowError("invalid snapshot");
+        return false;
     }
+
+    v8::Local<v8::Array> jsChildren = Nan::New<v8::Array>();
+
+    for (uint32_t i = 0; i < count; i++) {
+        v8::Local<v8::Object> jsChild;
+
+        if (!loadSceneNode(reader, types, scene, jsChild) || !addSceneChild(jsNode, jsChildren, jsChild, scene)) {
+            return false;
+        }
+    }
+
+    res = jsNode;
+
+    return true;
 }
 
 /**
@@ -929,85 +2613,345 @@ NAN_METHOD(AminoGfx::UpdatePerspective) {
 
     gfx->renderer->setupPerspective(perspective);
 
-    //use in next rendering cycle
-    gfx->viewportChanged = true;
-}
+    //use in next rendering cycle
+    gfx->viewportChanged = true;
+}
+
+/**
+ * Get runtime statistics.
+ */
+NAN_METHOD(AminoGfx::GetStats) {
+    AminoGfx *gfx = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+
+    assert(gfx);
+
+    v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+
+    gfx->getStats(obj);
+
+    info.GetReturnValue().Set(obj);
+}
+
+/**
+ * Get runtime statistics.
+ */
+void AminoGfx::getStats(v8::Local<v8::Object> &obj) {
+    //JS objects
+    Nan::Set(obj, Nan::New("activeInstances").ToLocalChecked(), Nan::New(activeInstances));
+    Nan::Set(obj, Nan::New("totalInstances").ToLocalChecked(), Nan::New(totalInstances));
+
+    //animations
+    Nan::Set(obj, Nan::New("animations").ToLocalChecked(), Nan::New((uint32_t)animations.size()));
+    Nan::Set(obj, Nan::New("timelines").ToLocalChecked(), Nan::New((uint32_t)timelines.size()));
+    Nan::Set(obj, Nan::New("animSets").ToLocalChecked(), Nan::New((uint32_t)animSets.size()));
+    Nan::Set(obj, Nan::New("animationTime").ToLocalChecked(), Nan::New(animTime));
+    Nan::Set(obj, Nan::New("framePeriod").ToLocalChecked(), Nan::New((double)framePeriod));
+
+    //main thread signals
+    Nan::Set(obj, Nan::New("skippedSignals").ToLocalChecked(), Nan::New(skippedSignals));
+
+    //textures
+    Nan::Set(obj, Nan::New("textures").ToLocalChecked(), Nan::New(textureCount));
+
+    //text layout cache (shared)
+    v8::Local<v8::Object> textCacheObj = Nan::New<v8::Object>();
+
+    AminoText::initTextCacheMutex();
+    uv_mutex_lock(&AminoText::textCacheMutex);
+
+    AminoTextCache &textCache = AminoText::textCache;
+    uint32_t hits = textCache.getHits();
+    uint32_t lookups = hits + textCache.getMisses();
+
+    Nan::Set(textCacheObj, Nan::New("hits").ToLocalChecked(), Nan::New(hits));
+    Nan::Set(textCacheObj, Nan::New("misses").ToLocalChecked(), Nan::New(textCache.getMisses()));
+    Nan::Set(textCacheObj, Nan::New("hitRate").ToLocalChecked(), Nan::New(lookups > 0 ? (double)hits / lookups : 0));
+    Nan::Set(textCacheObj, Nan::New("entries").ToLocalChecked(), Nan::New((uint32_t)textCache.getEntryCount()));
+    Nan::Set(textCacheObj, Nan::New("memory").ToLocalChecked(), Nan::New((double)textCache.getMemory()));
+
+    uv_mutex_unlock(&AminoText::textCacheMutex);
+
+    Nan::Set(obj, Nan::New("textCache").ToLocalChecked(), textCacheObj);
+
+    //pending text layouts
+    uv_mutex_lock(&layoutLock);
+    Nan::Set(obj, Nan::New("pendingTextLayouts").ToLocalChecked(), Nan::New((uint32_t)(layoutJobs.size() + layoutResults.size())));
+    uv_mutex_unlock(&layoutLock);
+
+    //text draw calls (last frame)
+    Nan::Set(obj, Nan::New("textDrawCalls").ToLocalChecked(), Nan::New(renderer ? renderer->getTextDrawCount() : 0));
+
+    //rendering performance (FPS)
+    if (MEASURE_FPS && lastFPS) {
+        //populate fps
+        v8::Local<v8::Object> fpsObj = Nan::New<v8::Object>();
+
+        Nan::Set(fpsObj, Nan::New("fps").ToLocalChecked(), Nan::New(lastFPS));
+        Nan::Set(fpsObj, Nan::New("start").ToLocalChecked(), Nan::New(lastCycleStart));
+        Nan::Set(fpsObj, Nan::New("max").ToLocalChecked(), Nan::New(lastCycleMax));
+        Nan::Set(fpsObj, Nan::New("min").ToLocalChecked(), Nan::New(lastCycleMin));
+        Nan::Set(fpsObj, Nan::New("avg").ToLocalChecked(), Nan::New(lastCycleAvg));
+        Nan::Set(obj, Nan::New("fps").ToLocalChecked(), fpsObj);
+    }
+
+    //renderer
+    if (SHOW_RENDERER_ERRORS) {
+        Nan::Set(obj, Nan::New("errors").ToLocalChecked(), Nan::New(rendererErrors));
+    }
+
+    //base class
+    AminoJSEventObject::getStats(obj);
+}
+
+/**
+ * Add animation.
+ *
+ * The animation is added to the rendering loop at the start of the next frame.
+ *
+ * Note: called on main thread.
+ */
+bool AminoGfx::addAnimation(AminoAnim *anim) {
+    if (destroyed) {
+        return false;
+    }
+
+    //retain anim instance (released after removal)
+    anim->retain();
+
+    //enqueue (lock-free)
+    pushAnimationChange(anim, true);
+
+    return true;
+}
+
+/**
+ * Remove animation.
+ *
+ * The animation is removed from the rendering loop at the start of the next frame. The instance gets destroyed afterwards
+ * on the main thread.
+ *
+ * Note: called on main thread.
+ *
+ * @return false if the instance has to be destroyed right now.
+ */
+bool AminoGfx::removeAnimation(AminoAnim *anim) {
+    if (destroyed) {
+        return false;
+    }
+
+    assert(anim);
+
+    //keep instance until removed
+    anim->retain();
+
+    //enqueue (lock-free)
+    pushAnimationChange(anim, false);
+
+    return true;
+}
+
+/**
+ * Add a pending animation change.
+ */
+void AminoGfx::pushAnimationChange(AminoAnim *anim, bool add) {
+    anim_change_t *change = new anim_change_t;
+
+    change->anim = anim;
+    change->add = add;
+    change->next = animChanges.load(std::memory_order_relaxed);
+
+    while (!animChanges.compare_exchange_weak(change->next, change, std::memory_order_release, std::memory_order_relaxed)) {
+        //retry
+    }
+}
+
+/**
+ * Apply all pending animation changes.
+ *
+ * Note: animLock has to be held.
+ *
+ * @param mainThread removed instances are destroyed right away.
+ */
+void AminoGfx::applyAnimationChanges(bool mainThread) {
+    anim_change_t *head = animChanges.exchange(NULL, std::memory_order_acquire);
+
+    if (!head) {
+        return;
+    }
+
+    //restore order
+    anim_change_t *list = NULL;
+
+    while (head) {
+        anim_change_t *next = head->next;
+
+        head->next = list;
+        list = head;
+        head = next;
+    }
+
+    //apply
+    while (list) {
+        anim_change_t *change = list;
+        AminoAnim *anim = change->anim;
+
+        bool add = change->add;
+
+        list = change->next;
+        delete change;
+
+        if (add) {
+            //append
+            std::size_t index = animations.size();
+
+            anim->animIndex = index;
+            animations.push_back(anim);
+
+            resizeAnimBatch(animBatch, index + 1);
+            anim->fillBatch(animBatch, index);
+
+            //check total
+            if (animations.size() % 100 == 0) {
+                printf("warning: %i animations reached!\n", (int)animations.size());
+            }
+
+            continue;
+        }
+
+        //swap-remove
+        int index = anim->animIndex;
+
+        if (index < 0) {
+            //animation not found (e.g. cleared)
+            if (DEBUG_RENDERER) {
+                printf("animation already stopped\n");
+            }
+
+            anim->removed(mainThread, false);
+            continue;
+        }
+
+        assert(animations[index] == anim);
+
+        std::size_t last = animations.size() - 1;
+
+        if ((std::size_t)index != last) {
+            AminoAnim *lastAnim = animations[last];
+
+            animations[index] = lastAnim;
+            lastAnim->animIndex = index;
+            moveAnimBatch(animBatch, last, index);
+        }
+
+        animations.pop_back();
+        resizeAnimBatch(animBatch, last);
+        anim->animIndex = -1;
+
+        //free instance
+        anim->removed(mainThread, true);
+
+        if (DEBUG_RENDERER) {
+            printf("animations: %i\n", (int)animations.size());
+        }
+    }
+}
+
+/**
+ * Resize the packed animation arrays.
+ */
+void AminoGfx::resizeAnimBatch(anim_batch_t &batch, std::size_t count) {
+    batch.startTime.resize(count);
+    batch.invDuration.resize(count);
+    batch.start.resize(count);
+    batch.end.resize(count);
+    batch.timeFunc.resize(count);
+    batch.reverse.resize(count);
+    batch.active.resize(count);
+    batch.pos.resize(count);
+    batch.value.resize(count);
+}
+
+/**
+ * Move a packed animation entry.
+ */
+void AminoGfx::moveAnimBatch(anim_batch_t &batch, std::size_t from, std::size_t to) {
+    batch.startTime[to] = batch.startTime[from];
+    batch.invDuration[to] = batch.invDuration[from];
+    batch.start[to] = batch.start[from];
+    batch.end[to] = batch.end[from];
+    batch.timeFunc[to] = batch.timeFunc[from];
+    batch.reverse[to] = batch.reverse[from];
+    batch.active[to] = batch.active[from];
+}
+
+/**
+ * Clear all animations now.
+ *
+ * Note: called on main thread.
+ */
+void AminoGfx::clearAnimations() {
+    if (destroyed) {
+        return;
+    }
+
+    //release all instances
+    int res = pthread_mutex_lock(&animLock);
+
+    assert(res == 0);
 
-/**
- * Get runtime statistics.
- */
-NAN_METHOD(AminoGfx::GetStats) {
-    AminoGfx *gfx = Nan::ObjectWrap::Unwrap<AminoGfx>(info.This());
+    applyAnimationChanges(true);
 
-    assert(gfx);
+    std::size_t count = animations.size();
 
-    v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+    for (std::size_t i = 0; i < count; i++) {
+        AminoAnim *item = animations[i];
 
-    gfx->getStats(obj);
+        item->animIndex = -1;
+        item->release();
+    }
 
-    info.GetReturnValue().Set(obj);
-}
+    animations.clear();
+    resizeAnimBatch(animBatch, 0);
 
-/**
- * Get runtime statistics.
- */
-void AminoGfx::getStats(v8::Local<v8::Object> &obj) {
-    //JS objects
-    Nan::Set(obj, Nan::New("activeInstances").ToLocalChecked(), Nan::New(activeInstances));
-    Nan::Set(obj, Nan::New("totalInstances").ToLocalChecked(), Nan::New(totalInstances));
+    count = timelines.size();
 
-    //animations
-    Nan::Set(obj, Nan::New("animations").ToLocalChecked(), Nan::New((uint32_t)animations.size()));
+    for (std::size_t i = 0; i < count; i++) {
+        timelines[i]->release();
+    }
 
-    //textures
-    Nan::Set(obj, Nan::New("textures").ToLocalChecked(), Nan::New(textureCount));
+    timelines.clear();
 
-    //rendering performance (FPS)
-    if (MEASURE_FPS && lastFPS) {
-        //populate fps
-        v8::Local<v8::Object> fpsObj = Nan::New<v8::Object>();
+    count = animSets.size();
 
-        Nan::Set(fpsObj, Nan::New("fps").ToLocalChecked(), Nan::New(lastFPS));
-        Nan::Set(fpsObj, Nan::New("start").ToLocalChecked(), Nan::New(lastCycleStart));
-        Nan::Set(fpsObj, Nan::New("max").ToLocalChecked(), Nan::New(lastCycleMax));
-        Nan::Set(fpsObj, Nan::New("min").ToLocalChecked(), Nan::New(lastCycleMin));
-        Nan::Set(fpsObj, Nan::New("avg").ToLocalChecked(), Nan::New(lastCycleAvg));
-        Nan::Set(obj, Nan::New("fps").ToLocalChecked(), fpsObj);
+    for (std::size_t i = 0; i < count; i++) {
+        animSets[i]->release();
     }
 
-    //renderer
-    if (SHOW_RENDERER_ERRORS) {
-        Nan::Set(obj, Nan::New("errors").ToLocalChecked(), Nan::New(rendererErrors));
-    }
+    animSets.clear();
 
-    //base class
-    AminoJSEventObject::getStats(obj);
+    res = pthread_mutex_unlock(&animLock);
+    assert(res == 0);
 }
 
 /**
- * Add animation.
+ * Add timeline.
  *
  * Note: called on main thread.
  */
-bool AminoGfx::addAnimation(AminoAnim *anim) {
+bool AminoGfx::addTimeline(AminoTimeline *timeline) {
     if (destroyed) {
         return false;
     }
 
-    //retain anim instance
-    anim->retain();
+    //retain timeline instance
+    timeline->retain();
 
     //add
     int res = pthread_mutex_lock(&animLock);
 
     assert(res == 0);
 
-    animations.push_back(anim);
-
-    //check total
-    if (animations.size() % 100 == 0) {
-        printf("warning: %i animations reached!\n", (int)animations.size());
-    }
+    timelines.push_back(timeline);
 
     res = pthread_mutex_unlock(&animLock);
     assert(res == 0);
@@ -1016,69 +2960,87 @@ bool AminoGfx::addAnimation(AminoAnim *anim) {
 }
 
 /**
- * Remove animation.
+ * Remove timeline.
  *
  * Note: called on main thread.
  */
-void AminoGfx::removeAnimation(AminoAnim *anim) {
+void AminoGfx::removeTimeline(AminoTimeline *timeline) {
     if (destroyed) {
         return;
     }
 
-    assert(anim);
+    assert(timeline);
 
     //remove
     int res = pthread_mutex_lock(&animLock);
 
     assert(res == 0);
 
-    std::vector<AminoAnim *>::iterator pos = std::find(animations.begin(), animations.end(), anim);
+    std::vector<AminoTimeline *>::iterator pos = std::find(timelines.begin(), timelines.end(), timeline);
 
-    if (pos != animations.end()) {
-        animations.erase(pos);
+    if (pos != timelines.end()) {
+        timelines.erase(pos);
 
         //free instance
-        anim->release();
-    } else {
-        //animation not found
-        if (DEBUG_RENDERER) {
-            printf("animation already stopped\n");
-        }
+        timeline->release();
     }
 
-    if (DEBUG_RENDERER) {
-        printf("animations: %i\n", (int)animations.size());
+    res = pthread_mutex_unlock(&animLock);
+    assert(res == 0);
+}
+
+/**
+ * Add animation set.
+ *
+ * Note: called on main thread.
+ */
+bool AminoGfx::addAnimSet(AminoAnimSet *animSet) {
+    if (destroyed) {
+        return false;
     }
 
+    //retain animation set instance
+    animSet->retain();
+
+    //add
+    int res = pthread_mutex_lock(&animLock);
+
+    assert(res == 0);
+
+    animSets.push_back(animSet);
+
     res = pthread_mutex_unlock(&animLock);
     assert(res == 0);
+
+    return true;
 }
 
 /**
- * Clear all animations now.
+ * Remove animation set.
  *
  * Note: called on main thread.
  */
-void AminoGfx::clearAnimations() {
+void AminoGfx::removeAnimSet(AminoAnimSet *animSet) {
     if (destroyed) {
         return;
     }
 
-    //release all instances
+    assert(animSet);
+
+    //remove
     int res = pthread_mutex_lock(&animLock);
 
     assert(res == 0);
 
-    std::size_t count = animations.size();
+    std::vector<AminoAnimSet *>::iterator pos = std::find(animSets.begin(), animSets.end(), animSet);
 
-    for (std::size_t i = 0; i < count; i++) {
-        AminoAnim *item = animations[i];
+    if (pos != animSets.end()) {
+        animSets.erase(pos);
 
-        item->release();
+        //free instance
+        animSet->release();
     }
 
-    animations.clear();
-
     res = pthread_mutex_unlock(&animLock);
     assert(res == 0);
 }
@@ -1126,168 +3088,376 @@ void AminoGfx::deleteTexture(AsyncValueUpdate *update, int state) {
 }
 
 /**
- * Delete buffer.
+ * Delete buffer.
+ *
+ * Note: has to be called on main thread.
+ */
+bool AminoGfx::deleteBufferAsync(GLuint bufferId) {
+    if (destroyed) {
+        return false;
+    }
+
+    if (DEBUG_BASE) {
+        printf("enqueue: delete buffer\n");
+    }
+
+    //enqueue
+    AminoJSObject::enqueueValueUpdate(bufferId, NULL, static_cast<asyncValueCallback>(&AminoGfx::deleteBuffer));
+
+    return true;
+}
+
+/**
+ * Delete buffer.
+ */
+void AminoGfx::deleteBuffer(AsyncValueUpdate *update, int state) {
+    if (state != AsyncValueUpdate::STATE_APPLY) {
+        return;
+    }
+
+    GLuint bufferId = update->valueUint32;
+
+    if (DEBUG_RESOURCES) {
+        printf("-> deleting buffer %i\n", bufferId);
+    }
+
+    glDeleteBuffers(1, &bufferId);
+}
+
+/**
+ * Delete vertex buffer.
+ *
+ * Note: has to be called on main thread.
+ */
+bool AminoGfx::deleteVertexBufferAsync(vertex_buffer_t *buffer) {
+    if (destroyed) {
+        return false;
+    }
+
+    if (DEBUG_BASE) {
+        printf("enqueue: delete vertex buffer\n");
+    }
+
+    //enqueue
+    AminoJSObject::enqueueValueUpdate(0, buffer, static_cast<asyncValueCallback>(&AminoGfx::deleteVertexBuffer));
+
+    return true;
+}
+
+/**
+ * Delete vertex buffer (on OpenGL thread).
+ */
+void AminoGfx::deleteVertexBuffer(AsyncValueUpdate *update, int state) {
+    if (state != AsyncValueUpdate::STATE_APPLY) {
+        return;
+    }
+
+    vertex_buffer_t *buffer = (vertex_buffer_t *)update->data;
+
+    assert(buffer);
+
+    if (DEBUG_RESOURCES) {
+        printf("-> deleting vertex buffer\n");
+    }
+
+    vertex_buffer_delete(buffer);
+}
+
+/**
+ * Collect text updates.
+ */
+void AminoGfx::textUpdateNeeded(AminoText *text) {
+    if (std::find(textUpdates.begin(), textUpdates.end(), text) == textUpdates.end()) {
+        textUpdates.push_back(text);
+    }
+}
+
+/**
+ * Update all modified text nodes.
+ */
+void AminoGfx::updateTextNodes() {
+    std::size_t count = textUpdates.size();
+
+#if (DEBUG_FONT_PERFORMANCE == 1)
+    //debug
+    double startTime = getTime(), diff;
+#endif
+
+    //layout modified texts
+    std::vector<texture_atlas_t *> textureUpdates;
+
+    for (std::size_t i = 0; i < count; i++) {
+        AminoText *item = textUpdates[i];
+
+        if (!item->fontSize) {
+            continue;
+        }
+
+        //cancel outdated job (result would overwrite the new layout)
+        cancelTextLayout(item);
+
+        if (!layoutThreadRunning || offline) {
+            //synchronous layout (offline frames have to be complete)
+            item->layoutText();
+        } else if (!item->useCachedLayout()) {
+            //layout on worker thread (previous layout is shown until done)
+            text_layout_job_t *job = item->createLayoutJob();
+
+            uv_mutex_lock(&layoutLock);
+
+            item->layoutJob = job;
+            layoutJobs.push_back(job);
+
+            uv_cond_signal(&layoutCond);
+            uv_mutex_unlock(&layoutLock);
+
+            continue;
+        }
+
+        //collect atlas pages (one texture per page)
+        for (auto const &page : item->pages) {
+            if (std::find(textureUpdates.begin(), textureUpdates.end(), page.atlas) == textureUpdates.end()) {
+                textureUpdates.push_back(page.atlas);
+            }
+        }
+    }
+
+    textUpdates.clear();
+
+    //finished layouts
+    applyTextLayouts(textureUpdates);
+
+#if (DEBUG_FONT_PERFORMANCE == 1)
+    //debug
+    diff = getTime() - startTime;
+    if (diff > 5) {
+        printf("layoutText: %i ms\n", (int)diff);
+    }
+#endif
+
+    //update textures
+    std::size_t textureCount = textureUpdates.size();
+
+#if (DEBUG_FONT_PERFORMANCE == 1)
+    //debug
+    startTime = getTime();
+#endif
+
+    for (std::size_t i = 0; i < textureCount; i++) {
+        texture_atlas_t *atlas = textureUpdates[i];
+
+        //upload modified regions
+        if (renderer->updateAtlasTexture(atlas)) {
+            //inform other amino instances to update shared texture
+            atlasTextureHasChanged(atlas);
+        }
+    }
+
+#if (DEBUG_FONT_PERFORMANCE == 1)
+    //debug
+    diff = getTime() - startTime;
+    if (diff > 5) {
+        printf("updateTexture: %i ms\n", (int)diff);
+    }
+#endif
+}
+
+/**
+ * Apply the layouts finished by the layout thread.
+ *
+ * Note: called on rendering thread.
+ */
+void AminoGfx::applyTextLayouts(std::vector<texture_atlas_t *> &textureUpdates) {
+    uv_mutex_lock(&layoutLock);
+
+    for (auto job : layoutResults) {
+        AminoText *item = job->text;
+
+        //check outdated or cancelled job
+        if (item && item->layoutJob == job) {
+            item->layoutJob = NULL;
+            item->applyLayout(job->layout);
+
+            //collect atlas pages
+            for (auto const &page : item->pages) {
+                if (std::find(textureUpdates.begin(), textureUpdates.end(), page.atlas) == textureUpdates.end()) {
+                    textureUpdates.push_back(page.atlas);
+                }
+            }
+        }
+
+        delete job;
+    }
+
+    layoutResults.clear();
+
+    uv_mutex_unlock(&layoutLock);
+}
+
+/**
+ * Cancel the pending layout of a text node.
  *
- * Note: has to be called on main thread.
+ * Note: called on main and rendering thread.
  */
-bool AminoGfx::deleteBufferAsync(GLuint bufferId) {
-    if (destroyed) {
-        return false;
-    }
+void AminoGfx::cancelTextLayout(AminoText *text) {
+    uv_mutex_lock(&layoutLock);
 
-    if (DEBUG_BASE) {
-        printf("enqueue: delete buffer\n");
+    if (text->layoutJob) {
+        text->layoutJob->text = NULL;
+        text->layoutJob = NULL;
     }
 
-    //enqueue
-    AminoJSObject::enqueueValueUpdate(bufferId, NULL, static_cast<asyncValueCallback>(&AminoGfx::deleteBuffer));
+    uv_mutex_unlock(&layoutLock);
+}
 
-    return true;
+/**
+ * Cancel the layout jobs of a font (all instances).
+ *
+ * Waits until a running job of the font is done.
+ *
+ * Note: called on main thread before the font is freed (font lock must not be held).
+ */
+void AminoGfx::cancelFontLayouts(AminoFont *font) {
+    for (auto const &item : instances) {
+        item->cancelFontLayoutJobs(font);
+    }
 }
 
 /**
- * Delete buffer.
+ * Cancel the layout jobs of a font.
  */
-void AminoGfx::deleteBuffer(AsyncValueUpdate *update, int state) {
-    if (state != AsyncValueUpdate::STATE_APPLY) {
-        return;
+void AminoGfx::cancelFontLayoutJobs(AminoFont *font) {
+    uv_mutex_lock(&layoutLock);
+
+    //queued and finished jobs (freed by the layout and rendering thread)
+    for (auto job : layoutJobs) {
+        if (job->aminoFont == font) {
+            cancelLayoutJob(job);
+        }
     }
 
-    GLuint bufferId = update->valueUint32;
+    for (auto job : layoutResults) {
+        if (job->aminoFont == font) {
+            cancelLayoutJob(job);
+        }
+    }
 
-    if (DEBUG_RESOURCES) {
-        printf("-> deleting buffer %i\n", bufferId);
+    //running job
+    while (layoutRunning && layoutRunning->aminoFont == font) {
+        uv_cond_wait(&layoutDoneCond, &layoutLock);
     }
 
-    glDeleteBuffers(1, &bufferId);
+    uv_mutex_unlock(&layoutLock);
 }
 
 /**
- * Delete vertex buffer.
+ * Cancel a layout job.
  *
- * Note: has to be called on main thread.
+ * Note: layout lock has to be held.
  */
-bool AminoGfx::deleteVertexBufferAsync(vertex_buffer_t *buffer) {
-    if (destroyed) {
-        return false;
-    }
-
-    if (DEBUG_BASE) {
-        printf("enqueue: delete vertex buffer\n");
+void AminoGfx::cancelLayoutJob(text_layout_job_t *job) {
+    if (job->text && job->text->layoutJob == job) {
+        job->text->layoutJob = NULL;
     }
 
-    //enqueue
-    AminoJSObject::enqueueValueUpdate(0, buffer, static_cast<asyncValueCallback>(&AminoGfx::deleteVertexBuffer));
-
-    return true;
+    job->text = NULL;
 }
 
 /**
- * Delete vertex buffer (on OpenGL thread).
+ * Start the text layout thread.
+ *
+ * Note: called on main thread.
  */
-void AminoGfx::deleteVertexBuffer(AsyncValueUpdate *update, int state) {
-    if (state != AsyncValueUpdate::STATE_APPLY) {
+void AminoGfx::startLayoutThread() {
+    if (layoutThreadRunning) {
         return;
     }
 
-    vertex_buffer_t *buffer = (vertex_buffer_t *)update->data;
-
-    assert(buffer);
+    layoutThreadRunning = true;
 
-    if (DEBUG_RESOURCES) {
-        printf("-> deleting vertex buffer\n");
-    }
+    int res = uv_thread_create(&layoutThread, layoutThreadLoop, this);
 
-    vertex_buffer_delete(buffer);
+    assert(res == 0);
 }
 
 /**
- * Collect text updates.
+ * Stop the text layout thread.
+ *
+ * Note: called on main thread.
  */
-void AminoGfx::textUpdateNeeded(AminoText *text) {
-    if (std::find(textUpdates.begin(), textUpdates.end(), text) == textUpdates.end()) {
-        textUpdates.push_back(text);
+void AminoGfx::stopLayoutThread() {
+    if (!layoutThreadRunning) {
+        return;
     }
-}
 
-/**
- * Update all modified text nodes.
- */
-void AminoGfx::updateTextNodes() {
-    std::size_t count = textUpdates.size();
+    uv_mutex_lock(&layoutLock);
+    layoutThreadRunning = false;
+    uv_cond_signal(&layoutCond);
+    uv_mutex_unlock(&layoutLock);
 
-    if (count == 0) {
-        return;
-    }
+    int res = uv_thread_join(&layoutThread);
 
-#if (DEBUG_FONT_PERFORMANCE == 1)
-    //debug
-    double startTime = getTime(), diff;
-#endif
+    assert(res == 0);
 
-    //layout modified texts
-    std::vector<AminoText *> textureUpdates;
+    //free remaining jobs (Note: thread stopped)
+    layoutJobs.insert(layoutJobs.end(), layoutResults.begin(), layoutResults.end());
 
-    for (std::size_t i = 0; i < count; i++) {
-        AminoText *item = textUpdates[i];
+    for (auto job : layoutJobs) {
+        if (job->text && job->text->layoutJob == job) {
+            job->text->layoutJob = NULL;
+        }
 
-        if (item->layoutText()) {
-            //find texture
-            std::size_t textureCount = textureUpdates.size();
-            GLuint textureId = item->getTextureId();
-            bool found = false;
+        delete job;
+    }
 
-            for (std::size_t j = 0; j < textureCount; j++) {
-                AminoText *item2 = textureUpdates[j];
+    layoutJobs.clear();
+    layoutResults.clear();
+}
 
-                if (item2->getTextureId() == textureId) {
-                    found = true;
-                    break;
-                }
-            }
+/**
+ * Text layout thread.
+ *
+ * Lays out text and rasterizes new glyphs. The results are applied by the rendering thread.
+ */
+void AminoGfx::layoutThreadLoop(void *arg) {
+    AminoGfx *gfx = static_cast<AminoGfx *>(arg);
 
-            if (!found) {
-                textureUpdates.push_back(item);
-            }
+    assert(gfx);
+
+    uv_mutex_lock(&gfx->layoutLock);
+
+    while (gfx->layoutThreadRunning) {
+        if (gfx->layoutJobs.empty()) {
+            uv_cond_wait(&gfx->layoutCond, &gfx->layoutLock);
+            continue;
         }
-    }
 
-    textUpdates.clear();
+        text_layout_job_t *job = gfx->layoutJobs.front();
 
-#if (DEBUG_FONT_PERFORMANCE == 1)
-    //debug
-    diff = getTime() - startTime;
-    if (diff > 5) {
-        printf("layoutText: %i ms\n", (int)diff);
-    }
-#endif
+        gfx->layoutJobs.pop_front();
 
-    //update textures
-    std::size_t textureCount = textureUpdates.size();
+        if (!job->text) {
+            //cancelled
+            delete job;
+            continue;
+        }
 
-#if (DEBUG_FONT_PERFORMANCE == 1)
-    //debug
-    startTime = getTime();
-#endif
+        //Note: font is not freed while running
+        gfx->layoutRunning = job;
 
-    for (std::size_t i = 0; i < textureCount; i++) {
-        AminoText *item = textureUpdates[i];
+        uv_mutex_unlock(&gfx->layoutLock);
 
-        item->updateTexture();
+        AminoText::runLayoutJob(job);
 
-        //inform other amino instances to update shared texture
-        texture_atlas_t *atlas = item->fontSize->fontTexture->atlas;
+        uv_mutex_lock(&gfx->layoutLock);
 
-        atlasTextureHasChanged(atlas);
-    }
+        gfx->layoutRunning = NULL;
+        uv_cond_broadcast(&gfx->layoutDoneCond);
 
-#if (DEBUG_FONT_PERFORMANCE == 1)
-    //debug
-    diff = getTime() - startTime;
-    if (diff > 5) {
-        printf("updateTexture: %i ms\n", (int)diff);
+        gfx->layoutResults.push_back(job);
     }
-#endif
+
+    uv_mutex_unlock(&gfx->layoutLock);
 }
 
 /**
@@ -1332,7 +3502,7 @@ void AminoGfx::updateAtlasTextureHandler(AsyncValueUpdate *update, int state) {
 
     texture_atlas_t *atlas = (texture_atlas_t *)update->data;
 
-    AminoText::updateTextureFromAtlas(update->valueUint32, atlas);
+    renderer->updateAtlasTexture(atlas);
 }
 
 /**
@@ -1480,29 +3650,12 @@ AminoJSObject* AminoTextFactory::create() {
 // AminoText
 //
 
-/**
- * Update texture.
- */
-void AminoText::updateTexture() {
-    if (DEBUG_FONT_UPDATES) {
-        printf("-> update font texture: %s\n", fontSize->font->getFontInfo().c_str());
-    }
-
-    assert(texture.textureId != INVALID_TEXTURE);
-    assert(fontSize);
-    assert(fontSize->fontTexture);
-
-    texture_atlas_t *atlas = fontSize->fontTexture->atlas;
-
-    assert(atlas);
-
-    updateTextureFromAtlas(texture.textureId, atlas);
-}
-
 /**
  * Update texture from atlas.
+ *
+ * Returns true if data was uploaded.
  */
-void AminoText::updateTextureFromAtlas(GLuint textureId, texture_atlas_t *atlas) {
+bool AminoText::updateTextureFromAtlas(amino_atlas_t &texture, texture_atlas_t *atlas) {
     //update texture
     if (DEBUG_BASE) {
         printf("-> updateTexture()\n");
@@ -1541,32 +3694,60 @@ void AminoText::updateTextureFromAtlas(GLuint textureId, texture_atlas_t *atlas)
         printf("\n");
     }
 
-    glBindTexture(GL_TEXTURE_2D, textureId);
+    //Note: glyphs are added to the atlas on several threads
+    uv_mutex_t *fontLock = AminoFont::getAtlasLock(atlas);
+
+    uv_mutex_lock(fontLock);
 
-    //Note: glTexSubImage2D() would probably be faster
+    size_t version = texture_atlas_get_version(atlas);
 
-    if (atlas->depth == 1) {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlas->width, atlas->height, 0, GL_ALPHA, GL_UNSIGNED_BYTE, atlas->data);
-    } else if (atlas->depth == 3) {
-        //Note: not supported so far
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, atlas->width, atlas->height, 0, GL_RGB, GL_UNSIGNED_BYTE, atlas->data);
+    if (texture.uploaded && texture.version == version) {
+        //no changes
+        uv_mutex_unlock(fontLock);
+
+        return false;
     }
 
-    //printf("font texture updated\n");
-    //printf("updateTexture() done\n");
-}
+    //Note: depth 3 not supported so far
+    GLenum format = atlas->depth == 3 ? GL_RGB : GL_ALPHA;
 
-/**
- * Get the font texture.
- */
-GLuint AminoText::getTextureId() {
-    return texture.textureId;
+    glBindTexture(GL_TEXTURE_2D, texture.textureId);
+
+    //modified rows (Note: OpenGL ES 2.0 has no GL_UNPACK_ROW_LENGTH, full rows are contiguous)
+    vector_t *regions = vector_new(sizeof(ivec4));
+
+    if (texture.uploaded && texture_atlas_get_dirty_rows(atlas, texture.version, regions)) {
+        std::size_t count = vector_size(regions);
+
+        for (std::size_t i = 0; i < count; i++) {
+            ivec4 *region = (ivec4 *)vector_get(regions, i);
+
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, region->y, atlas->width, region->height, format, GL_UNSIGNED_BYTE, atlas->data + region->y * atlas->width * atlas->depth);
+        }
+
+        if (DEBUG_FONT_UPDATES) {
+            printf("-> texture %i: %i regions\n", (int)texture.textureId, (int)count);
+        }
+    } else {
+        //full upload
+        glTexImage2D(GL_TEXTURE_2D, 0, format, atlas->width, atlas->height, 0, format, GL_UNSIGNED_BYTE, atlas->data);
+
+        texture.uploaded = true;
+    }
+
+    vector_delete(regions);
+
+    texture.version = version;
+
+    uv_mutex_unlock(fontLock);
+
+    return true;
 }
 
 /**
  * Render text to vertices.
  */
-void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, const char *text, vec2 *pen, int wrap, int width, int *lineNr, int maxLines, float *lineW) {
+void AminoText::addTextGlyphs(vertex_buffer_t *buffer, std::vector<texture_atlas_t *> &glyphAtlases, texture_font_t *font, const char *text, vec2 *pen, int wrap, int width, int *lineNr, int maxLines, float *lineW) {
     //see https://github.com/rougier/freetype-gl/blob/master/demos/glyph.c
     size_t len = utf8_strlen(text);
 
@@ -1586,20 +3767,27 @@ void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, con
     uint32_t textUtf32[len];
     bool done = false;
 
+    //Note: only locked while glyphs are loaded (glyphs are not modified afterwards)
+    uv_mutex_t *fontLock = AminoFont::getAtlasLock(font->atlas);
+
     for (size_t i = 0; i < len; ++i) {
+        uv_mutex_lock(fontLock);
+
         texture_glyph_t *glyph = texture_font_get_glyph(font, textPos);
 
+        //kerning
+        int kerning = 0;
+
+        if (glyph && linePos > 0) {
+            kerning = texture_font_get_kerning(font, lastTextPos, textPos);
+        }
+
+        uv_mutex_unlock(fontLock);
+
         if (glyph) {
             //store
             textUtf32[i] = glyph->codepoint;
 
-            //kerning
-            int kerning = 0;
-
-            if (linePos > 0) {
-                kerning = texture_glyph_get_kerning(glyph, lastTextPos);
-            }
-
             //wrap
             bool skip = false;
 
@@ -1660,6 +3848,7 @@ void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, con
 
                             //remove white space
                             vertex_buffer_erase(buffer, start);
+                            glyphAtlases.erase(glyphAtlases.begin() + start);
                             count--;
 
                             //update existing glyphs
@@ -1704,6 +3893,8 @@ void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, con
                                 for (size_t j = start; j < count; j++) {
                                     vertex_buffer_erase(buffer, start);
                                 }
+
+                                glyphAtlases.erase(glyphAtlases.begin() + start, glyphAtlases.end());
                             }
                         }
                     }
@@ -1767,6 +3958,7 @@ void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, con
 
                 //append
                 vertex_buffer_push_back(buffer, vertices, 4, indices, 6);
+                glyphAtlases.push_back(glyph->atlas);
                 linePos++;
 
                 //next
@@ -1802,77 +3994,239 @@ void AminoText::addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, con
 }
 
 /**
- * Update the rendered text.
+ * Update the rendered text (synchronous).
  *
- * Returns true if texture has changed and must be updated.
+ * Note: called on rendering thread.
  */
-bool AminoText::layoutText() {
-    //printf("layoutText()\n");
-
+void AminoText::layoutText() {
     if (!fontSize) {
-        //printf("-> no font\n");
-
-        return false;
+        return;
     }
 
     if (DEBUG_FONT_UPDATES) {
         printf("->layoutText() render text (%s)\n", fontSize->font->fontName.c_str());
     }
 
-    //Note: FreeType glyph code is not thread-safe, using lock to prevent crash on macOS if multiple AminoGfx instances are active
-    uv_mutex_lock(&freeTypeMutex);
+    //check cache (same text laid out by another node)
+    if (useCachedLayout()) {
+        return;
+    }
+
+    //Note: the font is only locked while glyphs are loaded (other fonts can be used in parallel)
+    AminoFont *font = fontSize->font;
+    texture_font_t *fontTexture = fontSize->fontTexture;
+    int width = getLayoutWidth();
+    text_cache_entry_t layout;
+
+    assert(fontTexture);
 
-    //create texture (needed in next calls)
-    assert(fontSize->fontTexture);
+    layout.key = AminoTextCache::createKey(fontTexture, propText->value, width, wrap, propMaxLines->value);
+    createLayout(layout, fontTexture, propText->value, width, wrap, propMaxLines->value);
 
-    texture_atlas_t *atlas = fontSize->fontTexture->atlas;
-    bool newTexture;
+    //Note: stored while the font is locked (font cannot be destroyed in the meantime)
+    font->lock();
 
-    assert(atlas);
-    assert(atlas->depth == 1);
+    uv_mutex_lock(&textCacheMutex);
+    textCache.store(layout);
+    uv_mutex_unlock(&textCacheMutex);
 
-    if (texture.textureId == INVALID_TEXTURE) {
-        //create or use existing texture (for atlas)
-        texture = getAminoGfx()->getAtlasTexture(atlas, true, newTexture);
+    font->unlock();
 
-        assert(texture.textureId != INVALID_TEXTURE);
+    applyLayout(layout);
+
+    if (DEBUG_BASE) {
+        printf("-> layoutText() done\n");
     }
+}
 
-    //render text
-    if (buffer) {
-        vertex_buffer_clear(buffer);
-    } else {
-        //vertex & texture coordinates
-        buffer = vertex_buffer_new("pos:3f,texCoord:2f");
+/**
+ * Use a cached layout if available.
+ *
+ * Note: called on rendering thread.
+ */
+bool AminoText::useCachedLayout() {
+    assert(fontSize);
+
+    uv_mutex_lock(&textCacheMutex);
+
+    std::string key = AminoTextCache::createKey(fontSize->fontTexture, propText->value, getLayoutWidth(), wrap, propMaxLines->value);
+    text_cache_entry_t *entry = textCache.find(key);
+
+    if (entry) {
+        applyLayout(*entry);
     }
 
-    texture_font_t *fontTexture = fontSize->fontTexture;
-    size_t lastGlyphCount = fontTexture->glyphs->size;
+    uv_mutex_unlock(&textCacheMutex);
 
-    assert(fontTexture);
+    return entry != NULL;
+}
+
+/**
+ * Create a layout job with the current values.
+ *
+ * Note: called on rendering thread.
+ */
+text_layout_job_t *AminoText::createLayoutJob() {
+    assert(fontSize);
+
+    text_layout_job_t *job = new text_layout_job_t();
+
+    job->text = this;
+    job->font = fontSize->fontTexture;
+    job->aminoFont = fontSize->font;
+    job->value = propText->value;
+    job->width = getLayoutWidth();
+    job->wrap = wrap;
+    job->maxLines = propMaxLines->value;
+
+    return job;
+}
+
+/**
+ * Lay out text and rasterize new glyphs.
+ *
+ * Note: called on layout thread.
+ */
+void AminoText::runLayoutJob(text_layout_job_t *job) {
+    text_cache_entry_t &layout = job->layout;
+
+    layout.key = AminoTextCache::createKey(job->font, job->value, job->width, job->wrap, job->maxLines);
+
+    //Note: the font is only locked while glyphs are loaded (no long waits on the rendering thread)
+    createLayout(layout, job->font, job->value, job->width, job->wrap, job->maxLines);
+
+    job->aminoFont->lock();
+
+    uv_mutex_lock(&textCacheMutex);
+    textCache.store(layout);
+    uv_mutex_unlock(&textCacheMutex);
 
+    job->aminoFont->unlock();
+}
+
+/**
+ * Render text to vertices (grouped by atlas page).
+ *
+ * Note: font lock must not be held.
+ */
+void AminoText::createLayout(text_cache_entry_t &layout, texture_font_t *font, const std::string &text, int width, int wrap, int maxLines) {
+    //vertex & texture coordinates
+    vertex_buffer_t *buffer = vertex_buffer_new("pos:3f,texCoord:2f");
+    std::vector<texture_atlas_t *> glyphAtlases;
     vec2 pen;
 
     pen.x = 0;
     pen.y = 0;
 
-    //Note: consider using async task to avoid performance issues
-    addTextGlyphs(buffer, fontTexture, propText->value.c_str(), &pen, wrap, propW->value, &lineNr, propMaxLines->value, &lineW);
+    addTextGlyphs(buffer, glyphAtlases, font, text.c_str(), &pen, wrap, width, &layout.lineNr, maxLines, &layout.lineW);
 
-    if (DEBUG_BASE) {
-        printf("-> layoutText() done\n");
+    //split by atlas page (first page always exists)
+    std::size_t count = glyphAtlases.size();
+    text_cache_page_t first;
+
+    first.atlas = count > 0 ? glyphAtlases[0] : font->atlas;
+
+    layout.font = font;
+    layout.memory = 0;
+    layout.pages.clear();
+    layout.pages.push_back(first);
+
+    for (std::size_t i = 0; i < count; i++) {
+        texture_atlas_t *atlas = glyphAtlases[i];
+        std::size_t pageCount = layout.pages.size();
+        std::size_t pos = 0;
+
+        while (pos < pageCount && layout.pages[pos].atlas != atlas) {
+            pos++;
+        }
+
+        if (pos == pageCount) {
+            text_cache_page_t page;
+
+            page.atlas = atlas;
+            layout.pages.push_back(page);
+        }
+
+        //glyph quad
+        ivec4 *item = (ivec4 *)vector_get(buffer->items, i);
+        GLfloat *vertices = (GLfloat *)vector_get(buffer->vertices, item->x);
+        std::vector<GLfloat> &target = layout.pages[pos].vertices;
+
+        target.insert(target.end(), vertices, vertices + 4 * sizeof(vertex_t) / sizeof(GLfloat));
+    }
+
+    //Note: no OpenGL buffers were created
+    vertex_buffer_delete(buffer);
+}
+
+/**
+ * Use a layout.
+ *
+ * Note: called on rendering thread.
+ */
+void AminoText::applyLayout(const text_cache_entry_t &layout) {
+    std::size_t pageCount = layout.pages.size();
+
+    //pages
+    while (pages.size() > pageCount) {
+        vertex_buffer_delete(pages.back().buffer);
+        pages.pop_back();
     }
 
-    size_t newGlyphCount = fontTexture->glyphs->size;
-    bool glyphsChanged = lastGlyphCount != newGlyphCount || (newTexture && newGlyphCount > 0);
+    while (pages.size() < pageCount) {
+        amino_text_page_t page = { NULL, { INVALID_TEXTURE }, vertex_buffer_new("pos:3f,texCoord:2f") };
 
-    uv_mutex_unlock(&freeTypeMutex);
+        pages.push_back(page);
+    }
 
-    //debug
-    //printf("glyphs changed: %i\n", glyphsChanged);
+    //vertices (copy)
+    std::vector<GLushort> indices;
+
+    for (std::size_t i = 0; i < pageCount; i++) {
+        const text_cache_page_t &layoutPage = layout.pages[i];
+        amino_text_page_t &page = pages[i];
+
+        if (page.atlas != layoutPage.atlas) {
+            page.atlas = layoutPage.atlas;
+            page.texture.textureId = INVALID_TEXTURE;
+        }
+
+        //create texture or use existing one (shared per atlas page)
+        if (page.texture.textureId == INVALID_TEXTURE) {
+            bool newTexture;
+
+            page.texture = getAminoGfx()->getAtlasTexture(page.atlas, true, newTexture);
+
+            assert(page.texture.textureId != INVALID_TEXTURE);
+        }
+
+        vertex_buffer_clear(page.buffer);
+
+        std::size_t vertexCount = layoutPage.vertices.size() * sizeof(GLfloat) / sizeof(vertex_t);
+
+        if (vertexCount == 0) {
+            continue;
+        }
+
+        //two triangles per glyph
+        indices.clear();
+
+        for (std::size_t j = 0; j < vertexCount; j += 4) {
+            GLushort quad[6] = { 0,1,2, 0,2,3 };
+
+            for (int k = 0; k < 6; k++) {
+                indices.push_back(j + quad[k]);
+            }
+        }
+
+        vertex_buffer_push_back(page.buffer, layoutPage.vertices.data(), vertexCount, indices.data(), indices.size());
+    }
 
-    return glyphsChanged;
+    //metrics
+    lineNr = layout.lineNr;
+    lineW = layout.lineW;
 }
 
-uv_mutex_t AminoText::freeTypeMutex;
-bool AminoText::freeTypeMutexInitialized = false;
\ No newline at end of file
+uv_mutex_t AminoText::textCacheMutex;
+AminoTextCache AminoText::textCache(256, 4 * 1024 * 1024);
+bool AminoText::textCacheMutexInitialized = false;
\ No newline at end of file
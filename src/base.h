@@ -10,12 +10,17 @@
 #include <uv.h>
 #include "shaders.h"
 #include "mathutils.h"
+#include "hittest.h"
+#include "textcache.h"
+#include "easing.h"
 #include <stdio.h>
 #include <vector>
 #include <stack>
+#include <deque>
 #include <stdlib.h>
 #include <string>
 #include <map>
+#include <atomic>
 
 #include "freetype-gl.h"
 #include "mat4.h"
@@ -35,8 +40,39 @@ const int MODEL = 6;
 class AminoText;
 class AminoGroup;
 class AminoAnim;
+class AminoTimeline;
+class AminoAnimSet;
 class AminoRenderer;
 
+/**
+ * Packed animation state (structure of arrays).
+ *
+ * Note: index matches the animations vector. All lanes are 32 bits wide (except the start time) to keep the kernel vectorizable.
+ */
+typedef struct {
+    //input
+    std::vector<double> startTime;
+    std::vector<float> invDuration;
+    std::vector<float> start;
+    std::vector<float> end;
+    std::vector<int32_t> timeFunc;
+    std::vector<int32_t> reverse;
+    std::vector<int32_t> active;
+
+    //output
+    std::vector<float> pos;
+    std::vector<float> value;
+} anim_batch_t;
+
+/**
+ * Pending animation change (lock-free list).
+ */
+typedef struct anim_change {
+    AminoAnim *anim;
+    bool add;
+    struct anim_change *next;
+} anim_change_t;
+
 /**
  * Amino main class to call from JavaScript.
  *
@@ -50,7 +86,11 @@ public:
     static NAN_MODULE_INIT(InitClasses);
 
     bool addAnimation(AminoAnim *anim);
-    void removeAnimation(AminoAnim *anim);
+    bool removeAnimation(AminoAnim *anim);
+    bool addTimeline(AminoTimeline *timeline);
+    void removeTimeline(AminoTimeline *timeline);
+    bool addAnimSet(AminoAnimSet *animSet);
+    void removeAnimSet(AminoAnimSet *animSet);
 
     bool deleteTextureAsync(GLuint textureId);
     bool deleteBufferAsync(GLuint bufferId);
@@ -58,12 +98,42 @@ public:
 
     //text
     void textUpdateNeeded(AminoText *text);
+    void cancelTextLayout(AminoText *text);
+    static void cancelFontLayouts(AminoFont *font);
     amino_atlas_t getAtlasTexture(texture_atlas_t *atlas, bool createIfMissing, bool &newTexture);
     void notifyTextureCreated(int count);
     static void updateAtlasTextures(texture_atlas_t *atlas);
 
     //video
     virtual AminoVideoPlayer *createVideoPlayer(AminoTexture *texture, AminoVideo *video) = 0;
+    void addVideoSync(AminoVideoPlayer *player);
+    void removeVideoSync(AminoVideoPlayer *player);
+    void waitVideoClock(AminoVideoPlayer *player, double time, bool &stop);
+
+    //hit testing
+    void removeFromHitIndex(AminoNode *node);
+
+    //frame clock
+    double getPresentationTime(double time);
+    double getClockTime();
+    bool isOffline();
+
+    //scene snapshot
+    typedef struct {
+        const char *data;
+        std::size_t size;
+        std::size_t pos;
+    } scene_reader_t;
+
+    //offline frame
+    typedef struct {
+        char *pixels;
+        std::size_t size;
+        int w;
+        int h;
+        uint32_t frame;
+        double time;
+    } offline_frame_t;
 
 protected:
     static int instanceCount;
@@ -82,7 +152,7 @@ protected:
     int viewportW;
     int viewportH;
     bool viewportChanged;
-    int32_t swapInterval = 0;
+    int32_t swapInterval = -1;
     GLint maxTextureSize = 0;
     int rendererErrors = 0;
     int textureCount = 0;
@@ -95,6 +165,25 @@ protected:
     std::vector<AminoText *> textUpdates;
 
     void updateTextNodes();
+    void applyTextLayouts(std::vector<texture_atlas_t *> &textureUpdates);
+
+    //text layout thread
+    uv_thread_t layoutThread;
+    bool layoutThreadRunning = false;
+    uv_mutex_t layoutLock;
+    uv_cond_t layoutCond;
+    uv_cond_t layoutDoneCond;
+    std::deque<text_layout_job_t *> layoutJobs;
+    std::vector<text_layout_job_t *> layoutResults;
+    text_layout_job_t *layoutRunning = NULL;
+
+    void startLayoutThread();
+    void stopLayoutThread();
+    static void layoutThreadLoop(void *arg);
+    void cancelFontLayoutJobs(AminoFont *font);
+    void cancelLayoutJob(text_layout_job_t *job);
+
+    //atlas textures
     virtual void atlasTextureHasChanged(texture_atlas_t *atlas);
     void updateAtlasTexture(texture_atlas_t *atlas);
     void updateAtlasTextureHandler(AsyncValueUpdate *update, int state);
@@ -138,7 +227,49 @@ protected:
 
     //animations
     std::vector<AminoAnim *> animations;
+    std::vector<AminoTimeline *> timelines;
+    std::vector<AminoAnimSet *> animSets;
     pthread_mutex_t animLock; //Note: short cycles
+    anim_batch_t animBatch;
+    std::atomic<anim_change_t *> animChanges { NULL };
+    double animTime = 0;
+
+    //frame clock (Note: read by other threads)
+    std::atomic<double> frameTime { 0 };
+    std::atomic<double> swapTime { 0 };
+    std::atomic<double> framePeriod { 0 };
+
+    //frame period estimation (Note: rendering thread)
+    std::vector<double> periodSamples;
+    uint32_t rejectedPeriods = 0;
+
+    //frame callbacks (requestFrame())
+    std::atomic<bool> frameRequested { false };
+    uint32_t skippedSignals = 0;
+
+    //offline rendering (virtual clock)
+    static constexpr double OFFLINE_START_TIME = 1000;
+
+    bool offline = false;
+    double offlineFrameDuration = 0;
+    std::atomic<double> virtualTime { 0 };
+    uint32_t offlineFrame = 0;
+    Nan::Callback *offlineCallback = NULL;
+    uv_sem_t offlineSem;
+
+    //offline video players (time up to which all frames are shown)
+    std::map<AminoVideoPlayer *, double> videoSyncTimes;
+    uv_mutex_t videoSyncLock;
+    uv_cond_t videoSyncCond;
+
+    void syncVideoPlayers();
+
+    //hit testing (Note: built while rendering if used)
+    AminoHitIndex *hitIndex = NULL;
+    AminoHitIndex *hitIndexBack = NULL;
+    std::atomic<bool> hitTestUsed { false };
+    std::vector<AminoNode *> hitRemovedNodes;
+    pthread_mutex_t hitLock;
 
     //creation
     static void Init(Nan::ADDON_REGISTER_FUNCTION_ARGS_TYPE target, AminoJSObjectFactory* factory);
@@ -160,15 +291,27 @@ protected:
     static void renderingThread(void *arg);
     static void handleRenderEvents(uv_async_t *handle);
     virtual void handleSystemEvents() = 0;
+    //Note: signal skipped if false and no JS updates are pending (RPi only, GLFW has to poll every frame)
+    virtual bool needsSystemEvents() { return true; };
 
     virtual void initRendering();
     virtual void render();
     virtual void endRendering();
     void processAnimations();
+    static void evaluateAnimations(anim_batch_t &batch, double currentTime, std::size_t count);
+    void pushAnimationChange(AminoAnim *anim, bool add);
+    void applyAnimationChanges(bool mainThread);
+    static void resizeAnimBatch(anim_batch_t &batch, std::size_t count);
+    static void moveAnimBatch(anim_batch_t &batch, std::size_t from, std::size_t to);
     virtual bool bindContext() = 0;
     virtual void renderScene();
     virtual void renderingDone() = 0;
     bool isRendering();
+    void updateFrameClock();
+    void readOfflineFrame();
+    void callOfflineFrame(JSCallbackUpdate *update);
+    void callFrame(JSCallbackUpdate *update);
+    void freeFrame(JSCallbackUpdate *update);
 
     void destroy() override;
     void destroyAminoGfx();
@@ -186,6 +329,25 @@ protected:
 
     void setRoot(AminoGroup *group);
 
+    //scene
+    typedef struct {
+        std::vector<AsyncPropertyUpdate *> updates;
+        std::vector<std::pair<AminoGroup *, AminoNode *>> children;
+    } scene_build_t;
+
+    bool buildSceneNode(v8::Local<v8::Object> &desc, v8::Local<v8::Object> &types, scene_build_t *scene, v8::Local<v8::Object> &res);
+    bool saveSceneNode(std::string &out, v8::Local<v8::Object> &jsNode, v8::Local<v8::Object> &types);
+    bool loadSceneNode(scene_reader_t *reader, v8::Local<v8::Object> &types, scene_build_t *scene, v8::Local<v8::Object> &res);
+
+    bool createSceneNode(const std::string &type, v8::Local<v8::Object> &types, v8::Local<v8::Object> &res);
+    bool setSceneAttribute(v8::Local<v8::Object> &jsNode, const std::string &key, v8::Local<v8::Value> value, scene_build_t *scene, bool &nativeValue);
+    void setSceneProperty(AnyProperty *prop, void *data, scene_build_t *scene);
+    void markSceneNode(v8::Local<v8::Object> &jsNode);
+    bool addSceneChild(v8::Local<v8::Object> &jsGroup, v8::Local<v8::Array> &jsChildren, v8::Local<v8::Object> &jsChild, scene_build_t *scene);
+    void applyScene(v8::Local<v8::Object> &root, scene_build_t *scene);
+    void freeScene(scene_build_t *scene);
+    void buildSceneHandler(AsyncValueUpdate *update, int state);
+
     void getStats(v8::Local<v8::Object> &obj) override;
 
 private:
@@ -196,10 +358,17 @@ private:
     static NAN_METHOD(Destroy);
 
     static NAN_METHOD(SetRoot);
+    static NAN_METHOD(BuildScene);
+    static NAN_METHOD(SaveScene);
+    static NAN_METHOD(LoadScene);
     static NAN_METHOD(ClearAnimations);
     static NAN_METHOD(UpdatePerspective);
     static NAN_METHOD(GetStats);
     static NAN_METHOD(GetTime);
+    static NAN_METHOD(GetClockTime);
+    static NAN_METHOD(GetFrameTime);
+    static NAN_METHOD(RequestFrame);
+    static NAN_METHOD(FindNodesAtXY);
 
     //animation
     void clearAnimations();
@@ -251,6 +420,9 @@ public:
     //visibility
     BooleanProperty *propVisible;
 
+    //position in parent group (rendering thread)
+    int childIndex = -1;
+
     AminoNode(std::string name, int type): AminoJSObject(name), type(type) {
         //empty
     }
@@ -300,6 +472,11 @@ public:
             return;
         }
 
+        //remove from hit index (Note: before event handler is cleared)
+        if (eventHandler) {
+            getAminoGfx()->removeFromHitIndex(this);
+        }
+
         AminoJSObject::destroy();
 
         //to be overwritten
@@ -374,7 +551,9 @@ public:
     //font
     ObjectProperty *propFont;
     AminoFontSize *fontSize = NULL;
-    vertex_buffer_t *buffer = NULL;
+
+    //glyphs (per atlas page)
+    std::vector<amino_text_page_t> pages;
 
     //alignment
     Utf8Property *propAlign;
@@ -387,9 +566,12 @@ public:
     int lineNr = 1;
     float lineW = 0;
 
-    //mutex
-    static uv_mutex_t freeTypeMutex;
-    static bool freeTypeMutexInitialized;
+    //layout cache mutex (Note: FreeType is guarded by the font locks)
+    static uv_mutex_t textCacheMutex;
+    static bool textCacheMutexInitialized;
+
+    //layout cache
+    static AminoTextCache textCache;
 
     //constants
     static const int ALIGN_LEFT   = 0x0;
@@ -407,7 +589,7 @@ public:
 
     AminoText(): AminoNode(getFactory()->name, TEXT) {
         //mutex
-        initFreeTypeMutex();
+        initTextCacheMutex();
     }
 
     ~AminoText() {
@@ -419,11 +601,11 @@ public:
     /**
      * Initialize the mutex.
      */
-    static void initFreeTypeMutex() {
-        if (!freeTypeMutexInitialized) {
-            freeTypeMutexInitialized = true;
+    static void initTextCacheMutex() {
+        if (!textCacheMutexInitialized) {
+            textCacheMutexInitialized = true;
 
-            int res = uv_mutex_init(&freeTypeMutex);
+            int res = uv_mutex_init(&textCacheMutex);
 
             assert(res == 0);
         }
@@ -448,7 +630,14 @@ public:
      * Free buffers.
      */
     void destroyAminoText() {
-        if (buffer) {
+        //pending layout
+        if (eventHandler) {
+            getAminoGfx()->cancelTextLayout(this);
+        }
+
+        for (auto &page : pages) {
+            vertex_buffer_t *buffer = page.buffer;
+
             if (eventHandler) {
                 if (getAminoGfx()->deleteVertexBufferAsync(buffer)) {
                     buffer = NULL;
@@ -461,16 +650,15 @@ public:
                 buffer->indices_id = 0;
 
                 vertex_buffer_delete(buffer);
-
-                buffer = NULL;
             }
         }
 
+        pages.clear();
+
         //release object values
         propFont->destroy();
 
         fontSize = NULL;
-        texture.textureId = INVALID_TEXTURE;
     }
 
     /**
@@ -614,9 +802,8 @@ public:
                 return;
             }
 
-            //new font
+            //new font (Note: textures are updated by the next layout)
             fontSize = fs;
-            texture.textureId = INVALID_TEXTURE; //reset texture
 
             //debug
             //printf("-> use font: %s\n", fs->font->fontName.c_str());
@@ -630,24 +817,30 @@ public:
     }
 
     /**
-     * Update the rendered text.
+     * Get the wrapping width in font units (SDF fonts are laid out at their base size).
      */
-    bool layoutText();
+    int getLayoutWidth() {
+        return fontSize->sdf ? (int)(propW->value / fontSize->scale) : (int)propW->value;
+    }
 
     /**
-     * Create or update a font texture.
+     * Update the rendered text.
      */
-    void updateTexture();
-    static void updateTextureFromAtlas(GLuint textureId, texture_atlas_t *atlas);
+    void layoutText();
+    bool useCachedLayout();
+    text_layout_job_t *createLayoutJob();
+    static void runLayoutJob(text_layout_job_t *job);
+    void applyLayout(const text_cache_entry_t &layout);
 
     /**
-     * Get font texture.
+     * Create or update a font texture.
      */
-    GLuint getTextureId();
+    static bool updateTextureFromAtlas(amino_atlas_t &texture, texture_atlas_t *atlas);
 
-private:
-    amino_atlas_t texture = { INVALID_TEXTURE };
+    //pending layout (Note: guarded by layout lock)
+    text_layout_job_t *layoutJob = NULL;
 
+private:
     /**
      * JS object construction.
      */
@@ -655,7 +848,8 @@ private:
         AminoJSObject::createInstance(info, getFactory());
     }
 
-    static void addTextGlyphs(vertex_buffer_t *buffer, texture_font_t *font, const char *text, vec2 *pen, int wrap, int width, int *lineNr, int maxLines, float *lineW);
+    static void addTextGlyphs(vertex_buffer_t *buffer, std::vector<texture_atlas_t *> &glyphAtlases, texture_font_t *font, const char *text, vec2 *pen, int wrap, int width, int *lineNr, int maxLines, float *lineW);
+    static void createLayout(text_cache_entry_t &layout, texture_font_t *font, const std::string &text, int width, int wrap, int maxLines);
 };
 
 /**
@@ -677,6 +871,7 @@ private:
 
     bool started = false;
     bool ended = false;
+    bool stopping = false;
 
     //properties
     float start;
@@ -686,8 +881,14 @@ private:
     bool autoreverse;
     int direction = FORWARD;
     int timeFunc = TF_CUBIC_IN_OUT;
+    AminoEasing *easing = NULL;
     Nan::Callback *then = NULL;
 
+    //JS notifications
+    int notify = NOTIFY_ALWAYS;
+    double notifyInterval = 0;
+    double lastNotifyTime = 0;
+
     //start pos
     float zeroPos;
     bool hasZeroPos = false;
@@ -705,12 +906,19 @@ private:
 
     static const int FOREVER = -1;
 
+    static const int NOTIFY_ALWAYS = 0;
+    static const int NOTIFY_END    = 1;
+    static const int NOTIFY_RATE   = 2;
+
 public:
     static const int TF_LINEAR       = 0x0;
     static const int TF_CUBIC_IN     = 0x1;
     static const int TF_CUBIC_OUT    = 0x2;
     static const int TF_CUBIC_IN_OUT = 0x3;
 
+    //index in AminoGfx animations (rendering thread)
+    int animIndex = -1;
+
     AminoAnim(): AminoJSObject(getFactory()->name) {
         //empty
     }
@@ -786,6 +994,11 @@ public:
             delete then;
             then = NULL;
         }
+
+        if (easing) {
+            delete easing;
+            easing = NULL;
+        }
     }
 
     //creation
@@ -856,20 +1069,39 @@ public:
 
         //time func
         Nan::Utf8String str(Nan::Get(data, Nan::New<v8::String>("timeFunc").ToLocalChecked()).ToLocalChecked());
+
         std::string tf = std::string(*str);
 
-        if (tf == "cubicIn") {
-            timeFunc = TF_CUBIC_IN;
-        } else if (tf == "cubicOut") {
-            timeFunc = TF_CUBIC_OUT;
-        } else if (tf == "cubicInOut") {
-            timeFunc = TF_CUBIC_IN_OUT;
-        } else {
-            timeFunc = TF_LINEAR;
-        }
+        timeFunc = parseTimeFunc(tf);
+        easing = AminoEasing::parse(tf, duration);
 
         //TODO support CSS key frames
 
+        //notify (JS updates)
+        v8::MaybeLocal<v8::Value> maybeNotify = Nan::Get(data, Nan::New<v8::String>("notify").ToLocalChecked());
+
+        if (!maybeNotify.IsEmpty()) {
+            v8::Local<v8::Value> notifyLocal = maybeNotify.ToLocalChecked();
+
+            if (notifyLocal->IsNumber()) {
+                //rate in Hz
+                double rate = notifyLocal->NumberValue();
+
+                if (rate > 0) {
+                    notify = NOTIFY_RATE;
+                    notifyInterval = 1000. / rate;
+                } else {
+                    notify = NOTIFY_END;
+                }
+            } else if (notifyLocal->IsString()) {
+                Nan::Utf8String notifyStr(notifyLocal);
+
+                if (std::string(*notifyStr) == "end") {
+                    notify = NOTIFY_END;
+                }
+            }
+        }
+
         //then
         v8::MaybeLocal<v8::Value> maybeThen = Nan::Get(data, Nan::New<v8::String>("then").ToLocalChecked());
 
@@ -911,11 +1143,30 @@ public:
         started = true;
     }
 
+    /**
+     * Get time function id.
+     */
+    static int parseTimeFunc(const std::string &tf) {
+        if (tf == "cubicIn") {
+            return TF_CUBIC_IN;
+        }
+
+        if (tf == "cubicOut") {
+            return TF_CUBIC_OUT;
+        }
+
+        if (tf == "cubicInOut") {
+            return TF_CUBIC_IN_OUT;
+        }
+
+        return TF_LINEAR;
+    }
+
     /**
      * Cubic-in time function.
      */
     static float cubicIn(float t) {
-        return pow(t, 3);
+        return t * t * t;
     }
 
     /**
@@ -937,31 +1188,34 @@ public:
     }
 
     /**
-     * Call time function.
+     * Apply a time function.
      */
-    float timeToPosition(float t) {
-        float t2 = 0;
-
+    static float applyTimeFunc(int timeFunc, float t) {
         switch (timeFunc) {
             case TF_CUBIC_IN:
-                t2 = cubicIn(t);
-                break;
+                return cubicIn(t);
 
             case TF_CUBIC_OUT:
-                t2 = cubicOut(t);
-                break;
+                return cubicOut(t);
 
             case TF_CUBIC_IN_OUT:
-                t2 = cubicInOut(t);
-                break;
+                return cubicInOut(t);
 
             case TF_LINEAR:
             default:
-                t2 = t;
-                break;
+                return t;
+        }
+    }
+
+    /**
+     * Call time function.
+     */
+    float timeToPosition(float t) {
+        if (easing) {
+            return start + (end - start) * easing->apply(t);
         }
 
-        return start + (end - start) * t2;
+        return start + (end - start) * applyTimeFunc(timeFunc, t);
     }
 
     /**
@@ -979,19 +1233,80 @@ public:
         }
     }
 
+    /**
+     * Check if the JS value has to be updated.
+     *
+     * Note: properties without JS listeners are only marked as stale.
+     */
+    bool needsNotify(double currentTime) {
+        if (!prop || !prop->watched) {
+            return false;
+        }
+
+        switch (notify) {
+            case NOTIFY_END:
+                return false;
+
+            case NOTIFY_RATE:
+                if (lastNotifyTime != 0 && currentTime - lastNotifyTime < notifyInterval) {
+                    return false;
+                }
+
+                lastNotifyTime = currentTime;
+                return true;
+
+            case NOTIFY_ALWAYS:
+            default:
+                return true;
+        }
+    }
+
     /**
      * Apply animation value.
      *
      * @param value current property value.
+     * @param notify update the JS value.
      */
-    void applyValue(float value) {
+    void applyValue(float value, bool notify) {
         if (!prop) {
             return;
         }
 
         FloatProperty *floatProp = static_cast<FloatProperty *>(prop);
 
-        floatProp->setValue(value);
+        floatProp->setValue(value, notify);
+    }
+
+    /**
+     * Store the running state in the packed animation arrays.
+     *
+     * Only running animations with a built-in time function are evaluated by the kernel. All other states (start, cycle end,
+     * end) and parametric time functions are handled by update().
+     */
+    void fillBatch(anim_batch_t &batch, std::size_t i) {
+        bool active = started && !ended && startTime != 0 && prop && duration > 0 && !easing;
+
+        batch.active[i] = active;
+
+        if (!active) {
+            return;
+        }
+
+        batch.startTime[i] = startTime;
+        batch.invDuration[i] = 1.f / duration;
+        batch.start[i] = start;
+        batch.end[i] = end;
+        batch.timeFunc[i] = timeFunc;
+        batch.reverse[i] = direction == BACKWARD;
+    }
+
+    /**
+     * Apply a value computed by the animation kernel.
+     */
+    void applyBatchValue(float value, double currentTime) {
+        lastTime = currentTime;
+
+        applyValue(value, needsNotify(currentTime));
     }
 
     //TODO pause
@@ -1015,23 +1330,63 @@ public:
      * Note: has to be called on main thread!
      */
     void stop() {
-        if (!destroyed) {
-            //keep instance until destroyed
-            retain();
+        if (destroyed || stopping) {
+            return;
+        }
 
-            //remove animation
-            if (eventHandler) {
-                (static_cast<AminoGfx *>(eventHandler))->removeAnimation(this);
-            }
+        //remove animation (destroyed after removal)
+        if (eventHandler && (static_cast<AminoGfx *>(eventHandler))->removeAnimation(this)) {
+            stopping = true;
+            return;
+        }
+
+        //keep instance until destroyed
+        retain();
 
-            //free resources
-            destroy();
+        //free resources
+        destroy();
+
+        //release instance
+        release();
+    }
 
-            //release instance
-            release();
+    /**
+     * Animation was removed from the rendering loop.
+     *
+     * @param mainThread called on main thread.
+     * @param retained instance is still retained by addAnimation().
+     */
+    void removed(bool mainThread, bool retained) {
+        jsUpdateCallback callback = retained ? static_cast<jsUpdateCallback>(&AminoAnim::freeRemoved) : static_cast<jsUpdateCallback>(&AminoAnim::freeStopped);
+
+        if (mainThread) {
+            (this->*callback)(NULL);
+        } else {
+            enqueueJSCallbackUpdate(callback, NULL, NULL);
         }
     }
 
+    /**
+     * Free removed animation on main thread.
+     */
+    void freeRemoved(JSCallbackUpdate *update) {
+        //release instance (retained by addAnimation())
+        release();
+
+        freeStopped(update);
+    }
+
+    /**
+     * Free stopped animation on main thread.
+     */
+    void freeStopped(JSCallbackUpdate *update) {
+        //free resources
+        destroy();
+
+        //release instance (retained by removeAnimation())
+        release();
+    }
+
     /**
      * End the animation.
      */
@@ -1046,8 +1401,8 @@ public:
 
         ended = true;
 
-        //apply end state
-        applyValue(end);
+        //apply end state (always sent to JS)
+        applyValue(end, true);
 
         //callback function
         if (then) {
@@ -1086,7 +1441,7 @@ public:
      */
     void update(double currentTime) {
         //check active
-    	if (!started || ended) {
+    	if (!started || ended || stopping) {
             return;
         }
 
@@ -1217,7 +1572,7 @@ public:
         //apply time function
         float value = timeToPosition(t);
 
-        applyValue(value);
+        applyValue(value, needsNotify(currentTime));
     }
 };
 
@@ -1702,6 +2057,11 @@ typedef struct {
     size_t pos;
 } group_insert_t;
 
+typedef struct {
+    size_t start;
+    size_t count;
+} group_range_t;
+
 /**
  * Group node.
  *
@@ -1709,8 +2069,9 @@ typedef struct {
  */
 class AminoGroup : public AminoNode {
 public:
-    //internal
+    //internal (Note: removed children are NULL until compacted)
     std::vector<AminoNode *> children;
+    std::size_t removedChildren = 0;
 
     //properties
     BooleanProperty *propClipRect;
@@ -1747,6 +2108,43 @@ public:
     void destroyAminoGroup() {
         //reset children
         children.clear();
+        removedChildren = 0;
+    }
+
+    /**
+     * Append a child.
+     *
+     * Note: has to be called on rendering thread.
+     */
+    void appendChild(AminoNode *node) {
+        node->childIndex = children.size();
+        children.push_back(node);
+    }
+
+    /**
+     * Remove the empty slots of removed children.
+     *
+     * Note: has to be called on rendering thread.
+     */
+    void compactChildren() {
+        if (removedChildren == 0) {
+            return;
+        }
+
+        std::size_t count = children.size();
+        std::size_t pos = 0;
+
+        for (std::size_t i = 0; i < count; i++) {
+            AminoNode *node = children[i];
+
+            if (node) {
+                node->childIndex = pos;
+                children[pos++] = node;
+            }
+        }
+
+        children.resize(pos);
+        removedChildren = 0;
     }
 
     void setup() override {
@@ -1788,6 +2186,9 @@ public:
         Nan::SetPrototypeMethod(tpl, "_add", Add);
         Nan::SetPrototypeMethod(tpl, "_insert", Insert);
         Nan::SetPrototypeMethod(tpl, "_remove", Remove);
+        Nan::SetPrototypeMethod(tpl, "_setChildren", SetChildren);
+        Nan::SetPrototypeMethod(tpl, "_reorder", Reorder);
+        Nan::SetPrototypeMethod(tpl, "_removeRange", RemoveRange);
 
         //template function
         return tpl;
@@ -1837,7 +2238,7 @@ private:
             printf("-> addChild()\n");
         }
 
-        children.push_back(node);
+        appendChild(node);
 
         //debug (provoke crash to get stack trace)
         if (DEBUG_CRASH) {
@@ -1891,7 +2292,17 @@ private:
                 printf("-> insertChild()\n");
             }
 
+            //Note: position does not include removed children
+            compactChildren();
+
             children.insert(children.begin() + data->pos, data->child);
+
+            //update indices
+            std::size_t count = children.size();
+
+            for (std::size_t i = data->pos; i < count; i++) {
+                children[i]->childIndex = i;
+            }
         } else if (state == AsyncValueUpdate::STATE_DELETE) {
             //on main thread
             group_insert_t *data = (group_insert_t *)update->data;
@@ -1934,12 +2345,210 @@ private:
 
         AminoNode *node = static_cast<AminoNode *>(update->valueObj);
 
-        //remove pointer
-        std::vector<AminoNode *>::iterator pos = std::find(children.begin(), children.end(), node);
+        //remove pointer (compacted later)
+        int pos = node->childIndex;
+
+        if (pos < 0 || pos >= (int)children.size() || children[pos] != node) {
+            //fallback
+            std::vector<AminoNode *>::iterator it = std::find(children.begin(), children.end(), node);
+
+            assert(it != children.end());
+
+            pos = it - children.begin();
+        }
+
+        children[pos] = NULL;
+        node->childIndex = -1;
+        removedChildren++;
+
+        //limit empty slots (e.g. group not rendered)
+        if (removedChildren >= 32 && removedChildren * 2 >= children.size()) {
+            compactChildren();
+        }
+    }
+
+    /**
+     * Replace all children.
+     *
+     * Parameters: new children, old children (kept until applied).
+     */
+    static NAN_METHOD(SetChildren) {
+        assert(info.Length() == 2);
+
+        AminoGroup *group = Nan::ObjectWrap::Unwrap<AminoGroup>(info.This());
+        v8::Local<v8::Array> arr = info[0].As<v8::Array>();
+        std::size_t count = arr->Length();
+        std::vector<AminoNode *> *nodes = new std::vector<AminoNode *>();
+
+        assert(group);
+
+        nodes->reserve(count);
+
+        for (std::size_t i = 0; i < count; i++) {
+            AminoNode *child = Nan::ObjectWrap::Unwrap<AminoNode>(arr->Get(i)->ToObject());
+
+            assert(child);
+
+            if (!child->checkRenderer(group)) {
+                delete nodes;
+                return;
+            }
+
+            nodes->push_back(child);
+        }
 
-        assert(pos != children.end());
+        //keep references until applied
+        v8::Local<v8::Array> refs = Nan::New<v8::Array>();
+
+        Nan::Set(refs, 0, info[0]);
+        Nan::Set(refs, 1, info[1]);
+
+        v8::Local<v8::Value> refsValue = refs;
+
+        //handle async
+        group->enqueueValueUpdate(refsValue, nodes, static_cast<asyncValueCallback>(&AminoGroup::setChildren));
+    }
+
+    /**
+     * Replace all children.
+     */
+    void setChildren(AsyncValueUpdate *update, int state) {
+        std::vector<AminoNode *> *nodes = (std::vector<AminoNode *> *)update->data;
 
-        children.erase(pos);
+        assert(nodes);
+
+        if (state == AsyncValueUpdate::STATE_APPLY) {
+            if (DEBUG_BASE) {
+                printf("-> setChildren()\n");
+            }
+
+            children.swap(*nodes);
+            removedChildren = 0;
+
+            //update indices
+            std::size_t count = children.size();
+
+            for (std::size_t i = 0; i < count; i++) {
+                children[i]->childIndex = i;
+            }
+        } else if (state == AsyncValueUpdate::STATE_DELETE) {
+            //on main thread
+            delete nodes;
+            update->data = NULL;
+        }
+    }
+
+    /**
+     * Reorder the children.
+     *
+     * Parameter: permutation (new position -> old position).
+     */
+    static NAN_METHOD(Reorder) {
+        assert(info.Length() == 1);
+
+        AminoGroup *group = Nan::ObjectWrap::Unwrap<AminoGroup>(info.This());
+        v8::Local<v8::Array> arr = info[0].As<v8::Array>();
+        std::size_t count = arr->Length();
+        std::vector<uint32_t> *perm = new std::vector<uint32_t>(count);
+
+        assert(group);
+
+        for (std::size_t i = 0; i < count; i++) {
+            (*perm)[i] = arr->Get(i)->Uint32Value();
+        }
+
+        //handle async
+        group->enqueueValueUpdate(count, perm, static_cast<asyncValueCallback>(&AminoGroup::reorderChildren));
+    }
+
+    /**
+     * Reorder the children.
+     */
+    void reorderChildren(AsyncValueUpdate *update, int state) {
+        std::vector<uint32_t> *perm = (std::vector<uint32_t> *)update->data;
+
+        assert(perm);
+
+        if (state == AsyncValueUpdate::STATE_APPLY) {
+            if (DEBUG_BASE) {
+                printf("-> reorderChildren()\n");
+            }
+
+            compactChildren();
+
+            std::size_t count = perm->size();
+
+            assert(count == children.size());
+
+            std::vector<AminoNode *> nodes(count);
+
+            for (std::size_t i = 0; i < count; i++) {
+                AminoNode *node = children[(*perm)[i]];
+
+                node->childIndex = i;
+                nodes[i] = node;
+            }
+
+            children.swap(nodes);
+        } else if (state == AsyncValueUpdate::STATE_DELETE) {
+            //on main thread
+            delete perm;
+            update->data = NULL;
+        }
+    }
+
+    /**
+     * Remove a range of children.
+     *
+     * Parameters: start, count, removed children (kept until applied).
+     */
+    static NAN_METHOD(RemoveRange) {
+        assert(info.Length() == 3);
+
+        AminoGroup *group = Nan::ObjectWrap::Unwrap<AminoGroup>(info.This());
+        group_range_t *data = new group_range_t();
+
+        assert(group);
+
+        data->start = info[0]->Uint32Value();
+        data->count = info[1]->Uint32Value();
+
+        //handle async
+        v8::Local<v8::Value> removed = info[2];
+
+        group->enqueueValueUpdate(removed, data, static_cast<asyncValueCallback>(&AminoGroup::removeChildRange));
+    }
+
+    /**
+     * Remove a range of children.
+     */
+    void removeChildRange(AsyncValueUpdate *update, int state) {
+        group_range_t *data = (group_range_t *)update->data;
+
+        assert(data);
+
+        if (state == AsyncValueUpdate::STATE_APPLY) {
+            if (DEBUG_BASE) {
+                printf("-> removeChildRange()\n");
+            }
+
+            compactChildren();
+
+            assert(data->start + data->count <= children.size());
+
+            children.erase(children.begin() + data->start, children.begin() + data->start + data->count);
+
+            //update indices
+            std::size_t count = children.size();
+
+            for (std::size_t i = data->start; i < count; i++) {
+                children[i]->childIndex = i;
+            }
+        } else if (state == AsyncValueUpdate::STATE_DELETE) {
+            //on main thread
+            delete data;
+            update->data = NULL;
+        }
     }
 };
 
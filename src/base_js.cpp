@@ -59,15 +59,25 @@ AminoJSObject::~AminoJSObject() {
         destroyAminoJSObject();
     }
 
-    //free properties
-    for (std::map<int, AnyProperty *>::iterator iter = propertyMap.begin(); iter != propertyMap.end(); iter++) {
-        delete iter->second;
+    //free properties (Note: allocated in property blocks)
+    std::size_t count = properties.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        properties[i]->~AnyProperty();
     }
 
     //debug
-    //printf("deleted %i properties\n", (int)propertyMap.size());
+    //printf("deleted %i properties\n", (int)count);
+
+    properties.clear();
+
+    count = propertyBlocks.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        delete[] propertyBlocks[i];
+    }
 
-    propertyMap.clear();
+    propertyBlocks.clear();
 
     //instance count
     activeInstances--;
@@ -250,7 +260,7 @@ void AminoJSObject::createInstance(Nan::NAN_METHOD_ARGS_TYPE info, AminoJSObject
  *
  * Note: has to be called in JS scope of setup()!
  */
-bool AminoJSObject::addPropertyWatcher(std::string name, int id, v8::Local<v8::Value> &jsValue) {
+bool AminoJSObject::addPropertyWatcher(std::string name, int id, v8::Local<v8::Value> &jsValue, bool &watched) {
     if (DEBUG_BASE) {
         printf("addPropertyWatcher(): %s\n", name.c_str());
     }
@@ -289,9 +299,34 @@ bool AminoJSObject::addPropertyWatcher(std::string name, int id, v8::Local<v8::V
 
     Nan::Set(obj, Nan::New<v8::String>("nativeListener").ToLocalChecked(), Nan::New<v8::Function>(*propertyUpdatedFunc));
 
+    //set nativeWatcher & nativeValue
+    if (!propertyWatchedFunc) {
+        propertyWatchedFunc = new Nan::Persistent<v8::Function>();
+        propertyWatchedFunc->Reset(Nan::New<v8::Function>(PropertyWatched));
+
+        propertyValueFunc = new Nan::Persistent<v8::Function>();
+        propertyValueFunc->Reset(Nan::New<v8::Function>(PropertyValue));
+    }
+
+    Nan::Set(obj, Nan::New<v8::String>("nativeWatcher").ToLocalChecked(), Nan::New<v8::Function>(*propertyWatchedFunc));
+    Nan::Set(obj, Nan::New<v8::String>("nativeValue").ToLocalChecked(), Nan::New<v8::Function>(*propertyValueFunc));
+
     //set propId value
     Nan::Set(obj, Nan::New<v8::String>("propId").ToLocalChecked(), Nan::New<v8::Integer>(id));
 
+    //check listeners (added before setup())
+    Nan::MaybeLocal<v8::Value> listenersMaybe = Nan::Get(obj, Nan::New<v8::String>("listeners").ToLocalChecked());
+
+    watched = false;
+
+    if (!listenersMaybe.IsEmpty()) {
+        v8::Local<v8::Value> listenersLocal = listenersMaybe.ToLocalChecked();
+
+        if (listenersLocal->IsArray()) {
+            watched = listenersLocal.As<v8::Array>()->Length() > 0;
+        }
+    }
+
     //default JS value
     Nan::MaybeLocal<v8::Value> valueMaybe = Nan::Get(obj, Nan::New<v8::String>("value").ToLocalChecked());
 
@@ -311,6 +346,8 @@ bool AminoJSObject::addPropertyWatcher(std::string name, int id, v8::Local<v8::V
 }
 
 Nan::Persistent<v8::Function>* AminoJSObject::propertyUpdatedFunc = NULL;
+Nan::Persistent<v8::Function>* AminoJSObject::propertyWatchedFunc = NULL;
+Nan::Persistent<v8::Function>* AminoJSObject::propertyValueFunc = NULL;
 
 /**
  * Create float property (bound to JS property).
@@ -319,7 +356,7 @@ Nan::Persistent<v8::Function>* AminoJSObject::propertyUpdatedFunc = NULL;
  */
 AminoJSObject::FloatProperty* AminoJSObject::createFloatProperty(std::string name) {
     int id = ++lastPropertyId;
-    FloatProperty *prop = new FloatProperty(this, name, id);
+    FloatProperty *prop = new (allocProperty(sizeof(FloatProperty))) FloatProperty(this, name, id);
 
     addProperty(prop);
 
@@ -333,7 +370,7 @@ AminoJSObject::FloatProperty* AminoJSObject::createFloatProperty(std::string nam
  */
 AminoJSObject::FloatArrayProperty* AminoJSObject::createFloatArrayProperty(std::string name) {
     int id = ++lastPropertyId;
-    FloatArrayProperty *prop = new FloatArrayProperty(this, name, id);
+    FloatArrayProperty *prop = new (allocProperty(sizeof(FloatArrayProperty))) FloatArrayProperty(this, name, id);
 
     addProperty(prop);
 
@@ -347,7 +384,7 @@ AminoJSObject::FloatArrayProperty* AminoJSObject::createFloatArrayProperty(std::
  */
 AminoJSObject::UShortArrayProperty* AminoJSObject::createUShortArrayProperty(std::string name) {
     int id = ++lastPropertyId;
-    UShortArrayProperty *prop = new UShortArrayProperty(this, name, id);
+    UShortArrayProperty *prop = new (allocProperty(sizeof(UShortArrayProperty))) UShortArrayProperty(this, name, id);
 
     addProperty(prop);
 
@@ -361,7 +398,7 @@ AminoJSObject::UShortArrayProperty* AminoJSObject::createUShortArrayProperty(std
  */
 AminoJSObject::Int32Property* AminoJSObject::createInt32Property(std::string name) {
     int id = ++lastPropertyId;
-    Int32Property *prop = new Int32Property(this, name, id);
+    Int32Property *prop = new (allocProperty(sizeof(Int32Property))) Int32Property(this, name, id);
 
     addProperty(prop);
 
@@ -375,7 +412,7 @@ AminoJSObject::Int32Property* AminoJSObject::createInt32Property(std::string nam
  */
 AminoJSObject::UInt32Property* AminoJSObject::createUInt32Property(std::string name) {
     int id = ++lastPropertyId;
-    UInt32Property *prop = new UInt32Property(this, name, id);
+    UInt32Property *prop = new (allocProperty(sizeof(UInt32Property))) UInt32Property(this, name, id);
 
     addProperty(prop);
 
@@ -389,7 +426,7 @@ AminoJSObject::UInt32Property* AminoJSObject::createUInt32Property(std::string n
  */
 AminoJSObject::BooleanProperty* AminoJSObject::createBooleanProperty(std::string name) {
     int id = ++lastPropertyId;
-    BooleanProperty *prop = new BooleanProperty(this, name, id);
+    BooleanProperty *prop = new (allocProperty(sizeof(BooleanProperty))) BooleanProperty(this, name, id);
 
     addProperty(prop);
 
@@ -403,7 +440,7 @@ AminoJSObject::BooleanProperty* AminoJSObject::createBooleanProperty(std::string
  */
 AminoJSObject::Utf8Property* AminoJSObject::createUtf8Property(std::string name) {
     int id = ++lastPropertyId;
-    Utf8Property *prop = new Utf8Property(this, name, id);
+    Utf8Property *prop = new (allocProperty(sizeof(Utf8Property))) Utf8Property(this, name, id);
 
     addProperty(prop);
 
@@ -417,13 +454,39 @@ AminoJSObject::Utf8Property* AminoJSObject::createUtf8Property(std::string name)
  */
 AminoJSObject::ObjectProperty* AminoJSObject::createObjectProperty(std::string name) {
     int id = ++lastPropertyId;
-    ObjectProperty *prop = new ObjectProperty(this, name, id);
+    ObjectProperty *prop = new (allocProperty(sizeof(ObjectProperty))) ObjectProperty(this, name, id);
 
     addProperty(prop);
 
     return prop;
 }
 
+/**
+ * Allocate property memory.
+ *
+ * Properties of an object are stored contiguously and freed in the destructor.
+ */
+void* AminoJSObject::allocProperty(std::size_t size) {
+    //align
+    const std::size_t align = alignof(std::max_align_t);
+
+    size = (size + align - 1) & ~(align - 1);
+
+    assert(size <= PROPERTY_BLOCK_SIZE);
+
+    //new block
+    if (propertyBlockUsed + size > PROPERTY_BLOCK_SIZE) {
+        propertyBlocks.push_back(new char[PROPERTY_BLOCK_SIZE]);
+        propertyBlockUsed = 0;
+    }
+
+    void *res = propertyBlocks.back() + propertyBlockUsed;
+
+    propertyBlockUsed += size;
+
+    return res;
+}
+
 /**
  * Bind a property to a watcher.
  *
@@ -438,12 +501,16 @@ void AminoJSObject::addProperty(AnyProperty *prop) {
 
     int id = prop->id;
 
-    propertyMap[id] = prop;
+    assert(id == (int)properties.size() + 1);
+
+    properties.push_back(prop);
 
     v8::Local<v8::Value> value;
+    bool watched;
 
-    if (addPropertyWatcher(prop->name, id, value)) {
+    if (addPropertyWatcher(prop->name, id, value, watched)) {
         prop->connected = true;
+        prop->watched = watched;
 
         //set default value
         bool valid = false;
@@ -458,6 +525,8 @@ void AminoJSObject::addProperty(AnyProperty *prop) {
 
 /**
  * Callback from property watcher to update native value.
+ *
+ * Returns true if the JS value is stale (e.g. typed array transferred to the native side).
  */
 NAN_METHOD(AminoJSObject::PropertyUpdated) {
     assert(info.Length() == 3);
@@ -473,6 +542,59 @@ NAN_METHOD(AminoJSObject::PropertyUpdated) {
     assert(obj);
 
     obj->enqueuePropertyUpdate(id, value);
+
+    info.GetReturnValue().Set(Nan::New<v8::Boolean>(obj->getPropertyWithId(id)->jsStale));
+}
+
+/**
+ * Callback from property watcher if the first listener was added or the last one removed.
+ */
+NAN_METHOD(AminoJSObject::PropertyWatched) {
+    assert(info.Length() == 3);
+
+    //params: watched, propId, object
+    bool watched = info[0]->BooleanValue();
+    int id = info[1]->IntegerValue();
+    v8::Local<v8::Object> jsObj = info[2].As<v8::Object>();
+    AminoJSObject *obj = Nan::ObjectWrap::Unwrap<AminoJSObject>(jsObj);
+
+    assert(obj);
+
+    AnyProperty *prop = obj->getPropertyWithId(id);
+
+    assert(prop);
+
+    prop->watched = watched;
+}
+
+/**
+ * Callback from property getter to read a stale native value.
+ *
+ * Note: values skipped by animations or set by scene builds are only read on demand.
+ */
+NAN_METHOD(AminoJSObject::PropertyValue) {
+    assert(info.Length() >= 2);
+
+    //params: propId, object, staleOnly
+    int id = info[0]->IntegerValue();
+    v8::Local<v8::Object> jsObj = info[1].As<v8::Object>();
+    AminoJSObject *obj = Nan::ObjectWrap::Unwrap<AminoJSObject>(jsObj);
+
+    assert(obj);
+
+    AnyProperty *prop = obj->getPropertyWithId(id);
+
+    assert(prop);
+
+    if (info.Length() > 2 && info[2]->BooleanValue() && !prop->jsStale) {
+        //JS value is current (returns undefined)
+        return;
+    }
+
+    //Note: clear before reading the value (a concurrent skip marks the property again)
+    prop->jsStale = false;
+
+    info.GetReturnValue().Set(prop->toValue());
 }
 
 /**
@@ -646,6 +768,9 @@ bool AminoJSObject::enqueuePropertyUpdate(int id, v8::Local<v8::Value> &value) {
         printf("enqueuePropertyUpdate: %s (id=%i)\n", prop->name.c_str(), id);
     }
 
+    //JS value is current again
+    prop->jsStale = false;
+
     return eventHandler->enqueuePropertyUpdate(prop, value);
 }
 
@@ -693,23 +818,23 @@ bool AminoJSObject::enqueueJSCallbackUpdate(jsUpdateCallback callbackApply, jsUp
  * Get property with id.
  */
 AminoJSObject::AnyProperty* AminoJSObject::getPropertyWithId(int id) {
-    std::map<int, AnyProperty *>::iterator iter = propertyMap.find(id);
-
-    if (iter == propertyMap.end()) {
+    if (id < 1 || id > (int)properties.size()) {
         //property not found
         return NULL;
     }
 
-    return iter->second;
+    return properties[id - 1];
 }
 
 /**
  * Get property with name.
  */
 AminoJSObject::AnyProperty* AminoJSObject::getPropertyWithName(std::string name) {
-    for (std::map<int, AnyProperty *>::iterator iter = propertyMap.begin(); iter != propertyMap.end(); iter++) {
-        if (iter->second->name == name) {
-            return iter->second;
+    std::size_t count = properties.size();
+
+    for (std::size_t i = 0; i < count; i++) {
+        if (properties[i]->name == name) {
+            return properties[i];
         }
     }
 
@@ -778,6 +903,9 @@ void AminoJSObject::updateProperty(AnyProperty *property) {
 
     assert(eventHandler);
 
+    //JS value is sent
+    property->jsStale = false;
+
     if (eventHandler->isMainThread()) {
         //create scope
         Nan::HandleScope scope;
@@ -790,6 +918,52 @@ void AminoJSObject::updateProperty(AnyProperty *property) {
     }
 }
 
+/**
+ * Skip a property update.
+ *
+ * The JS property is marked as stale once and reads the native value on demand.
+ *
+ * Note: call is thread-safe.
+ */
+void AminoJSObject::skipPropertyUpdate(AnyProperty *property) {
+    assert(property);
+
+    if (property->jsStale) {
+        return;
+    }
+
+    property->jsStale = true;
+
+    enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoJSObject::markPropertyStale), NULL, property);
+}
+
+/**
+ * Mark JS property as stale on main thread.
+ */
+void AminoJSObject::markPropertyStale(JSCallbackUpdate *update) {
+    AnyProperty *property = (AnyProperty *)update->data;
+
+    //check value was read or sent in the meantime
+    if (!property->jsStale) {
+        return;
+    }
+
+    //get property function
+    Nan::MaybeLocal<v8::Value> prop = Nan::Get(handle(), Nan::New<v8::String>(property->name).ToLocalChecked());
+
+    if (prop.IsEmpty()) {
+        return;
+    }
+
+    v8::Local<v8::Value> propLocal = prop.ToLocalChecked();
+
+    if (!propLocal->IsObject()) {
+        return;
+    }
+
+    Nan::Set(propLocal.As<v8::Object>(), Nan::New<v8::String>("stale").ToLocalChecked(), Nan::True());
+}
+
 /**
  * Convert a JS value to a string.
  */
@@ -826,7 +1000,7 @@ std::vector<AminoJSObject *> AminoJSObject::jsInstances;
 /**
  * AnyProperty constructor.
  */
-AminoJSObject::AnyProperty::AnyProperty(int type, AminoJSObject *obj, std::string name, int id): type(type), obj(obj), name(name), id(id) {
+AminoJSObject::AnyProperty::AnyProperty(int type, AminoJSObject *obj, std::string name, int id): type(type), obj(obj), name(internName(name)), id(id) {
     //empty
 
     assert(obj);
@@ -836,6 +1010,18 @@ AminoJSObject::AnyProperty::~AnyProperty() {
     //empty
 }
 
+/**
+ * Get the shared instance of a property name.
+ *
+ * Note: has to be called on v8 thread!
+ */
+const std::string& AminoJSObject::AnyProperty::internName(std::string name) {
+    //Note: never freed, references stay valid
+    static std::set<std::string> names;
+
+    return *names.insert(name).first;
+}
+
 /**
  * Retain base object instance.
  *
@@ -878,11 +1064,26 @@ AminoJSObject::FloatProperty::~FloatProperty() {
  * Note: only updates the JS value if modified!
  */
 void AminoJSObject::FloatProperty::setValue(float newValue) {
-    if (value != newValue) {
-        value = newValue;
+    setValue(newValue, true);
+}
 
-        if (connected) {
+/**
+ * Update the float value.
+ *
+ * Note: if notify is false, the JS value is only marked as stale. The next notification is sent even if the value did not change.
+ */
+void AminoJSObject::FloatProperty::setValue(float newValue, bool notify) {
+    if (value == newValue && !(notify && jsStale)) {
+        return;
+    }
+
+    value = newValue;
+
+    if (connected) {
+        if (notify) {
             obj->updateProperty(this);
+        } else {
+            obj->skipPropertyUpdate(this);
         }
     }
 }
@@ -943,6 +1144,112 @@ void AminoJSObject::FloatProperty::freeAsyncData(void *data) {
     }
 }
 
+//
+// AminoJSObject::TypedArrayData
+//
+
+/**
+ * Keep the memory of a typed array.
+ */
+AminoJSObject::TypedArrayStorage::TypedArrayStorage(void *memory, std::size_t size, v8::ArrayBuffer::Allocator *allocator): memory(memory), size(size), allocator(allocator) {
+    //empty
+}
+
+/**
+ * Free the memory.
+ */
+AminoJSObject::TypedArrayStorage::~TypedArrayStorage() {
+    if (allocator) {
+        allocator->Free(memory, size);
+    } else {
+        free(memory);
+    }
+}
+
+/**
+ * Take the data of a typed array.
+ *
+ * The ArrayBuffer is transferred (detached on JS side) if the view covers the whole buffer. Shared or external buffers
+ * (e.g. pooled Node.js buffers) are copied once.
+ */
+AminoJSObject::TypedArrayData::TypedArrayData(v8::Local<v8::ArrayBufferView> view, std::size_t elementSize, bool &transferred) {
+    v8::Local<v8::ArrayBuffer> buffer = view->Buffer();
+
+    //Note: view length, not the whole buffer (read before detaching)
+    std::size_t offset = view->ByteOffset();
+    std::size_t size = view->ByteLength();
+
+    transferred = false;
+
+    if (size > 0 && offset == 0 && size == buffer->ByteLength() && !buffer->IsExternal() && buffer->IsNeuterable()) {
+        //transfer
+        v8::ArrayBuffer::Contents contents = buffer->Externalize();
+
+        buffer->Neuter();
+
+        storage = std::make_shared<TypedArrayStorage>(contents.Data(), contents.ByteLength(), v8::Isolate::GetCurrent()->GetArrayBufferAllocator());
+        transferred = true;
+    } else {
+        //copy
+        void *memory = size > 0 ? malloc(size):NULL;
+
+        if (memory) {
+            size = view->CopyContents(memory, size);
+        } else {
+            size = 0;
+        }
+
+        storage = std::make_shared<TypedArrayStorage>(memory, size, (v8::ArrayBuffer::Allocator *)NULL);
+    }
+
+    data = storage->memory;
+    length = size / elementSize;
+}
+
+/**
+ * Allocate native data (filled by the caller).
+ */
+AminoJSObject::TypedArrayData::TypedArrayData(std::size_t length, std::size_t elementSize): length(length) {
+    void *memory = length > 0 ? malloc(length * elementSize):NULL;
+
+    if (!memory) {
+        this->length = 0;
+    }
+
+    storage = std::make_shared<TypedArrayStorage>(memory, this->length * elementSize, (v8::ArrayBuffer::Allocator *)NULL);
+    data = memory;
+}
+
+/**
+ * Share the data of another value (no copy).
+ */
+AminoJSObject::TypedArrayData::TypedArrayData(TypedArrayData *other): data(other->data), length(other->length), storage(other->storage) {
+    //empty
+}
+
+/**
+ * Release the data (freed with the last reference).
+ */
+AminoJSObject::TypedArrayData::~TypedArrayData() {
+    //empty
+}
+
+/**
+ * Copy the data to a new ArrayBuffer.
+ *
+ * Note: has to be called on main thread.
+ */
+v8::Local<v8::ArrayBuffer> AminoJSObject::TypedArrayData::copyToBuffer(std::size_t elementSize) {
+    std::size_t size = length * elementSize;
+    v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), size);
+
+    if (size > 0) {
+        memcpy(buffer->GetContents().Data(), data, size);
+    }
+
+    return buffer;
+}
+
 //
 // AminoJSObject::FloatArrayProperty
 //
@@ -955,25 +1262,32 @@ AminoJSObject::FloatArrayProperty::FloatArrayProperty(AminoJSObject *obj, std::s
 }
 
 /**
- * FloatProperty destructor.
+ * FloatArrayProperty destructor.
  */
 AminoJSObject::FloatArrayProperty::~FloatArrayProperty() {
-    //empty
+    if (value) {
+        delete value;
+        value = NULL;
+    }
+
+    if (jsValue) {
+        delete jsValue;
+        jsValue = NULL;
+    }
 }
 
 /**
- * Update the float value.
- *
- * Note: only updates the JS value if modified!
+ * Get the float values.
  */
-void AminoJSObject::FloatArrayProperty::setValue(std::vector<float> newValue) {
-    if (value != newValue) {
-        value = newValue;
+float* AminoJSObject::FloatArrayProperty::getData() {
+    return value ? (float *)value->data:NULL;
+}
 
-        if (connected) {
-            obj->updateProperty(this);
-        }
-    }
+/**
+ * Get the number of float values.
+ */
+std::size_t AminoJSObject::FloatArrayProperty::getLength() {
+    return value ? value->length:0;
 }
 
 /**
@@ -981,7 +1295,8 @@ void AminoJSObject::FloatArrayProperty::setValue(std::vector<float> newValue) {
  */
 std::string AminoJSObject::FloatArrayProperty::toString() {
     std::ostringstream ss;
-    std::size_t count = value.size();
+    float *data = getData();
+    std::size_t count = getLength();
 
     ss << "[";
 
@@ -990,7 +1305,7 @@ std::string AminoJSObject::FloatArrayProperty::toString() {
             ss << ", ";
         }
 
-        ss << value[i];
+        ss << data[i];
     }
 
     ss << "]";
@@ -1002,78 +1317,88 @@ std::string AminoJSObject::FloatArrayProperty::toString() {
  * Get JS value.
  */
 v8::Local<v8::Value> AminoJSObject::FloatArrayProperty::toValue() {
-    std::size_t count = value.size();
-
-    //typed array
-    v8::Local<v8::Float32Array> arr = v8::Float32Array::New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), count * sizeof(float)), 0, count);
-
-    //normal array
-    //v8::Local<v8::Array> arr = Nan::New<v8::Array>();
-
-    for (unsigned int i = 0; i < count; i++) {
-        Nan::Set(arr, Nan::New<v8::Uint32>(i), Nan::New<v8::Number>(value[i]));
+    //copy of the last assigned value (Note: the data is owned by the native side)
+    if (jsValue) {
+        return v8::Float32Array::New(jsValue->copyToBuffer(sizeof(float)), 0, jsValue->length);
     }
 
-    return arr;
+    return v8::Float32Array::New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), 0), 0, 0);
 }
 
 /**
  * Get async data representation.
+ *
+ * Note: Float32Array values are transferred to the native side (JS array is detached) and uploaded from there.
  */
 void* AminoJSObject::FloatArrayProperty::getAsyncData(v8::Local<v8::Value> &value, bool &valid) {
-    if (value->IsNull()) {
-        //Note: only accepting empty arrays as values
-        valid = false;
-
-        return NULL;
-    }
-
-    std::vector<float> *vector =  NULL;
+    TypedArrayData *res;
 
     if (value->IsFloat32Array()) {
         //Float32Array
-        v8::Handle<v8::Float32Array> arr = v8::Handle<v8::Float32Array>::Cast(value);
-        v8::ArrayBuffer::Contents contents = arr->Buffer()->GetContents();
-        float *data = (float *)contents.Data();
-        std::size_t count = contents.ByteLength() / sizeof(float);
+        bool transferred;
 
-        //debug
-        //printf("is Float32Array (size: %i)\n", (int)count);
+        res = new TypedArrayData(value.As<v8::Float32Array>(), sizeof(float), transferred);
 
-        //copy to vector
-        vector = new std::vector<float>();
-
-        vector->assign(data, data + count);
-
-        valid = true;
+        if (transferred) {
+            //JS value was detached (getter reads a copy)
+            jsStale = true;
+        }
     } else if (value->IsArray()) {
-        v8::Handle<v8::Array> arr = v8::Handle<v8::Array>::Cast(value);
-        std::size_t count = arr->Length();
+        //convert
+        v8::Local<v8::Array> arr = value.As<v8::Array>();
 
-        vector = new std::vector<float>();
+        res = new TypedArrayData(arr->Length(), sizeof(float));
 
-        for (std::size_t i = 0; i < count; i++) {
-            vector->push_back((float)(arr->Get(i)->NumberValue()));
-        }
+        float *data = (float *)res->data;
 
-        valid = true;
+        for (std::size_t i = 0; i < res->length; i++) {
+            data[i] = (float)(arr->Get(i)->NumberValue());
+        }
     } else {
+        //Note: only accepting arrays as values
         valid = false;
+
+        return NULL;
+    }
+
+    //keep for the JS getter (shared data)
+    if (jsValue) {
+        delete jsValue;
     }
 
-    return vector;
+    jsValue = new TypedArrayData(res);
+    valid = true;
+
+    return res;
 }
 
 /**
  * Apply async data.
+ *
+ * Note: the previous array is passed back to the update and released on the main thread.
  */
 void AminoJSObject::FloatArrayProperty::setAsyncData(AsyncPropertyUpdate *update, void *data) {
-    if (!data) {
-        value.clear();
+    TypedArrayData *arr = (TypedArrayData *)data;
+
+    if (!update) {
+        //main thread (default or scene value): keep own references
+        if (value) {
+            delete value;
+        }
+
+        value = arr ? new TypedArrayData(arr):NULL;
+
+        if (jsValue) {
+            delete jsValue;
+        }
+
+        jsValue = arr ? new TypedArrayData(arr):NULL;
         return;
     }
 
-    value = *((std::vector<float> *)data);
+    //swap
+    update->data = value;
+    value = arr;
 }
 
 /**
@@ -1081,7 +1406,7 @@ void AminoJSObject::FloatArrayProperty::setAsyncData(AsyncPropertyUpdate *update
  */
 void AminoJSObject::FloatArrayProperty::freeAsyncData(void *data) {
     if (data) {
-        delete (std::vector<float> *)data;
+        delete (TypedArrayData *)data;
     }
 }
 
@@ -1097,25 +1422,32 @@ AminoJSObject::UShortArrayProperty::UShortArrayProperty(AminoJSObject *obj, std:
 }
 
 /**
- * FloatProperty destructor.
+ * UShortArrayProperty destructor.
  */
 AminoJSObject::UShortArrayProperty::~UShortArrayProperty() {
-    //empty
+    if (value) {
+        delete value;
+        value = NULL;
+    }
+
+    if (jsValue) {
+        delete jsValue;
+        jsValue = NULL;
+    }
 }
 
 /**
- * Update the float value.
- *
- * Note: only updates the JS value if modified!
+ * Get the ushort values.
  */
-void AminoJSObject::UShortArrayProperty::setValue(std::vector<ushort> newValue) {
-    if (value != newValue) {
-        value = newValue;
+ushort* AminoJSObject::UShortArrayProperty::getData() {
+    return value ? (ushort *)value->data:NULL;
+}
 
-        if (connected) {
-            obj->updateProperty(this);
-        }
-    }
+/**
+ * Get the number of ushort values.
+ */
+std::size_t AminoJSObject::UShortArrayProperty::getLength() {
+    return value ? value->length:0;
 }
 
 /**
@@ -1123,7 +1455,8 @@ void AminoJSObject::UShortArrayProperty::setValue(std::vector<ushort> newValue)
  */
 std::string AminoJSObject::UShortArrayProperty::toString() {
     std::ostringstream ss;
-    std::size_t count = value.size();
+    ushort *data = getData();
+    std::size_t count = getLength();
 
     ss << "[";
 
@@ -1132,7 +1465,7 @@ std::string AminoJSObject::UShortArrayProperty::toString() {
             ss << ", ";
         }
 
-        ss << value[i];
+        ss << data[i];
     }
 
     ss << "]";
@@ -1144,78 +1477,88 @@ std::string AminoJSObject::UShortArrayProperty::toString() {
  * Get JS value.
  */
 v8::Local<v8::Value> AminoJSObject::UShortArrayProperty::toValue() {
-    std::size_t count = value.size();
-
-    //typed array
-    v8::Local<v8::Uint16Array> arr = v8::Uint16Array::New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), count * sizeof(ushort)), 0, count);
-
-    //normal array
-    //v8::Local<v8::Array> arr = Nan::New<v8::Array>();
-
-    for (unsigned int i = 0; i < count; i++) {
-        Nan::Set(arr, Nan::New<v8::Uint32>(i), Nan::New<v8::Number>(value[i]));
+    //copy of the last assigned value (Note: the data is owned by the native side)
+    if (jsValue) {
+        return v8::Uint16Array::New(jsValue->copyToBuffer(sizeof(ushort)), 0, jsValue->length);
     }
 
-    return arr;
+    return v8::Uint16Array::New(v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), 0), 0, 0);
 }
 
 /**
  * Get async data representation.
+ *
+ * Note: Uint16Array values are transferred to the native side (JS array is detached) and uploaded from there.
  */
 void* AminoJSObject::UShortArrayProperty::getAsyncData(v8::Local<v8::Value> &value, bool &valid) {
-    if (value->IsNull()) {
-        //Note: only accepting empty arrays as values
-        valid = false;
-
-        return NULL;
-    }
-
-    std::vector<ushort> *vector =  NULL;
+    TypedArrayData *res;
 
     if (value->IsUint16Array()) {
         //Uint16Array
-        v8::Handle<v8::Uint16Array> arr = v8::Handle<v8::Uint16Array>::Cast(value);
-        v8::ArrayBuffer::Contents contents = arr->Buffer()->GetContents();
-        ushort *data = (ushort *)contents.Data();
-        std::size_t count = contents.ByteLength() / sizeof(ushort);
-
-        //debug
-        //printf("is Float32Array (size: %i)\n", (int)count);
+        bool transferred;
 
-        //copy to vector
-        vector = new std::vector<ushort>();
+        res = new TypedArrayData(value.As<v8::Uint16Array>(), sizeof(ushort), transferred);
 
-        vector->assign(data, data + count);
-
-        valid = true;
+        if (transferred) {
+            //JS value was detached (getter reads a copy)
+            jsStale = true;
+        }
     } else if (value->IsArray()) {
-        v8::Handle<v8::Array> arr = v8::Handle<v8::Array>::Cast(value);
-        std::size_t count = arr->Length();
+        //convert
+        v8::Local<v8::Array> arr = value.As<v8::Array>();
 
-        vector = new std::vector<ushort>();
+        res = new TypedArrayData(arr->Length(), sizeof(ushort));
 
-        for (std::size_t i = 0; i < count; i++) {
-            vector->push_back((ushort)(arr->Get(i)->Uint32Value()));
-        }
+        ushort *data = (ushort *)res->data;
 
-        valid = true;
+        for (std::size_t i = 0; i < res->length; i++) {
+            data[i] = (ushort)(arr->Get(i)->Uint32Value());
+        }
     } else {
+        //Note: only accepting arrays as values
         valid = false;
+
+        return NULL;
+    }
+
+    //keep for the JS getter (shared data)
+    if (jsValue) {
+        delete jsValue;
     }
 
-    return vector;
+    jsValue = new TypedArrayData(res);
+    valid = true;
+
+    return res;
 }
 
 /**
  * Apply async data.
+ *
+ * Note: the previous array is passed back to the update and released on the main thread.
  */
 void AminoJSObject::UShortArrayProperty::setAsyncData(AsyncPropertyUpdate *update, void *data) {
-    if (!data) {
-        value.clear();
+    TypedArrayData *arr = (TypedArrayData *)data;
+
+    if (!update) {
+        //main thread (default or scene value): keep own references
+        if (value) {
+            delete value;
+        }
+
+        value = arr ? new TypedArrayData(arr):NULL;
+
+        if (jsValue) {
+            delete jsValue;
+        }
+
+        jsValue = arr ? new TypedArrayData(arr):NULL;
         return;
     }
 
-    value = *((std::vector<ushort> *)data);
+    //swap
+    update->data = value;
+    value = arr;
 }
 
 /**
@@ -1223,7 +1566,7 @@ void AminoJSObject::UShortArrayProperty::setAsyncData(AsyncPropertyUpdate *updat
  */
 void AminoJSObject::UShortArrayProperty::freeAsyncData(void *data) {
     if (data) {
-        delete (std::vector<ushort> *)data;
+        delete (TypedArrayData *)data;
     }
 }
 
@@ -2003,6 +2346,22 @@ void AminoJSEventObject::handleJSUpdates() {
     assert(res == 0);
 }
 
+/**
+ * Check if JS updates or deletes are waiting for the main thread.
+ */
+bool AminoJSEventObject::hasPendingJSUpdates() {
+    int res = pthread_mutex_lock(&asyncLock);
+
+    assert(res == 0);
+
+    bool pending = !jsUpdates->empty() || !asyncDeletes->empty();
+
+    res = pthread_mutex_unlock(&asyncLock);
+    assert(res == 0);
+
+    return pending;
+}
+
 /**
  * Get runtime specific data.
  */
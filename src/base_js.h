@@ -6,6 +6,7 @@
 #include <nan.h>
 
 #include <map>
+#include <set>
 #include <memory>
 #include <pthread.h>
 
@@ -83,10 +84,14 @@ protected:
     public:
         int type;
         AminoJSObject *obj;
-        std::string name;
+        const std::string &name; //interned
         int id;
         bool connected = false;
 
+        //JS state (Note: not synchronized, worst case an additional update is sent)
+        bool watched = false;
+        bool jsStale = false;
+
         AnyProperty(int type, AminoJSObject *obj, std::string name, int id);
         virtual ~AnyProperty();
 
@@ -103,6 +108,8 @@ protected:
         //weak reference control (obj)
         void retain();
         void release();
+
+        static const std::string& internName(std::string name);
     };
 
     class FloatProperty : public AnyProperty {
@@ -113,6 +120,7 @@ protected:
         ~FloatProperty();
 
         void setValue(float newValue);
+        void setValue(float newValue, bool notify);
 
         std::string toString() override;
 
@@ -125,14 +133,57 @@ protected:
         void freeAsyncData(void *data) override;
     };
 
+    /**
+     * Memory of a typed array value.
+     *
+     * Note: either taken from a detached ArrayBuffer (freed by the array buffer allocator) or allocated by malloc().
+     */
+    class TypedArrayStorage {
+    public:
+        void *memory;
+        std::size_t size;
+        v8::ArrayBuffer::Allocator *allocator;
+
+        TypedArrayStorage(void *memory, std::size_t size, v8::ArrayBuffer::Allocator *allocator);
+        ~TypedArrayStorage();
+    };
+
+    /**
+     * Typed array value.
+     *
+     * The memory is owned by the native side and never modified (shared by the JS getter and the renderer).
+     *
+     * Note: has to be created on main thread.
+     */
+    class TypedArrayData {
+    public:
+        void *data = NULL;
+        std::size_t length = 0;
+
+        TypedArrayData(v8::Local<v8::ArrayBufferView> view, std::size_t elementSize, bool &transferred);
+        TypedArrayData(std::size_t length, std::size_t elementSize);
+        TypedArrayData(TypedArrayData *other);
+        ~TypedArrayData();
+
+        v8::Local<v8::ArrayBuffer> copyToBuffer(std::size_t elementSize);
+
+    private:
+        std::shared_ptr<TypedArrayStorage> storage;
+    };
+
     class FloatArrayProperty : public AnyProperty {
     public:
-        std::vector<float> value;
+        //renderer value
+        TypedArrayData *value = NULL;
+
+        //last assigned value (main thread)
+        TypedArrayData *jsValue = NULL;
 
         FloatArrayProperty(AminoJSObject *obj, std::string name, int id);
         ~FloatArrayProperty();
 
-        void setValue(std::vector<float> newValue);
+        float* getData();
+        std::size_t getLength();
 
         std::string toString() override;
 
@@ -147,12 +198,17 @@ protected:
 
     class UShortArrayProperty : public AnyProperty {
     public:
-        std::vector<ushort> value;
+        //renderer value
+        TypedArrayData *value = NULL;
+
+        //last assigned value (main thread)
+        TypedArrayData *jsValue = NULL;
 
         UShortArrayProperty(AminoJSObject *obj, std::string name, int id);
         ~UShortArrayProperty();
 
-        void setValue(std::vector<ushort> newValue);
+        ushort* getData();
+        std::size_t getLength();
 
         std::string toString() override;
 
@@ -378,11 +434,19 @@ protected:
     static void createInstance(Nan::NAN_METHOD_ARGS_TYPE info, AminoJSObjectFactory* factory);
 
 private:
-    //properties
+    //properties (Note: index is id - 1)
     int lastPropertyId = 0;
-    std::map<int, AnyProperty *> propertyMap;
+    std::vector<AnyProperty *> properties;
+
+    //property storage (contiguous blocks)
+    static const std::size_t PROPERTY_BLOCK_SIZE = 1024;
 
-    bool addPropertyWatcher(std::string name, int id, v8::Local<v8::Value> &jsValue);
+    std::vector<char *> propertyBlocks;
+    std::size_t propertyBlockUsed = PROPERTY_BLOCK_SIZE;
+
+    void* allocProperty(std::size_t size);
+
+    bool addPropertyWatcher(std::string name, int id, v8::Local<v8::Value> &jsValue, bool &watched);
     void addProperty(AnyProperty *prop);
 
     //async updates
@@ -390,9 +454,18 @@ private:
     static NAN_METHOD(PropertyUpdated);
     static Nan::Persistent<v8::Function> *propertyUpdatedFunc;
 
+    static NAN_METHOD(PropertyWatched);
+    static Nan::Persistent<v8::Function> *propertyWatchedFunc;
+
+    static NAN_METHOD(PropertyValue);
+    static Nan::Persistent<v8::Function> *propertyValueFunc;
+
     //JS updates
     virtual bool enqueueJSPropertyUpdate(AnyProperty *prop);
 
+    void skipPropertyUpdate(AnyProperty *property);
+    void markPropertyStale(JSCallbackUpdate *update);
+
 public:
     std::string getName();
 
@@ -434,6 +507,7 @@ protected:
     void clearAsyncQueue();
     void handleAsyncDeletes();
     void handleJSUpdates();
+    bool hasPendingJSUpdates();
 
     virtual void getStats(v8::Local<v8::Object> &obj);
 
@@ -0,0 +1,225 @@
+#include "easing.h"
+
+#include <cmath>
+#include <cstdio>
+
+//
+// AminoEasing
+//
+
+/**
+ * Destructor.
+ */
+AminoEasing::~AminoEasing() {
+    //empty
+}
+
+/**
+ * Create a parametric time function.
+ *
+ * Supported:
+ *
+ *   - cubic-bezier(x1, y1, x2, y2)
+ *   - spring(stiffness, damping, mass[, velocity])
+ *
+ * @param duration animation duration in milliseconds.
+ * @return time function or NULL if not parametric.
+ */
+AminoEasing* AminoEasing::parse(const std::string &str, float duration) {
+    float p[4];
+
+    if (sscanf(str.c_str(), "cubic-bezier(%f ,%f ,%f ,%f", &p[0], &p[1], &p[2], &p[3]) == 4) {
+        if (p[0] < 0 || p[0] > 1 || p[2] < 0 || p[2] > 1) {
+            printf("invalid cubic-bezier: %s\n", str.c_str());
+            return NULL;
+        }
+
+        return new CubicBezierEasing(p[0], p[1], p[2], p[3]);
+    }
+
+    p[3] = 0;
+
+    if (sscanf(str.c_str(), "spring(%f ,%f ,%f ,%f", &p[0], &p[1], &p[2], &p[3]) >= 3) {
+        if (p[0] <= 0 || p[1] < 0 || p[2] <= 0) {
+            printf("invalid spring: %s\n", str.c_str());
+            return NULL;
+        }
+
+        return new SpringEasing(p[0], p[1], p[2], p[3], duration);
+    }
+
+    return NULL;
+}
+
+//
+// CubicBezierEasing
+//
+
+/**
+ * Constructor.
+ */
+CubicBezierEasing::CubicBezierEasing(float x1, float y1, float x2, float y2) {
+    linear = x1 == y1 && x2 == y2;
+
+    cx = 3 * x1;
+    bx = 3 * (x2 - x1) - cx;
+    ax = 1 - cx - bx;
+
+    cy = 3 * y1;
+    by = 3 * (y2 - y1) - cy;
+    ay = 1 - cy - by;
+
+    //sample table
+    for (int i = 0; i < SAMPLE_COUNT; i++) {
+        samples[i] = sampleX(i / (float)(SAMPLE_COUNT - 1));
+    }
+}
+
+/**
+ * Get x value of the curve.
+ */
+float CubicBezierEasing::sampleX(float t) {
+    return ((ax * t + bx) * t + cx) * t;
+}
+
+/**
+ * Get y value of the curve.
+ */
+float CubicBezierEasing::sampleY(float t) {
+    return ((ay * t + by) * t + cy) * t;
+}
+
+/**
+ * Get dx/dt.
+ */
+float CubicBezierEasing::sampleDerivativeX(float t) {
+    return (3 * ax * t + 2 * bx) * t + cx;
+}
+
+/**
+ * Find the curve parameter for an x value.
+ *
+ * Starts with the sample table, then uses Newton-Raphson. Falls back to bisection on flat slopes.
+ */
+float CubicBezierEasing::solveT(float x) {
+    //find interval
+    const float step = 1.f / (SAMPLE_COUNT - 1);
+    int i = 1;
+    float start = 0;
+
+    while (i < SAMPLE_COUNT - 1 && samples[i] <= x) {
+        start += step;
+        i++;
+    }
+
+    i--;
+
+    //interpolate
+    float t = start + step * (x - samples[i]) / (samples[i + 1] - samples[i]);
+    float slope = sampleDerivativeX(t);
+
+    if (slope >= 0.001f) {
+        //Newton-Raphson
+        for (int j = 0; j < NEWTON_ITERATIONS; j++) {
+            slope = sampleDerivativeX(t);
+
+            if (slope == 0) {
+                break;
+            }
+
+            t -= (sampleX(t) - x) / slope;
+        }
+
+        return t;
+    }
+
+    if (slope == 0) {
+        return t;
+    }
+
+    //bisection
+    float a = start;
+    float b = start + step;
+
+    for (int j = 0; j < SUBDIVISION_ITERATIONS; j++) {
+        t = (a + b) / 2;
+
+        float diff = sampleX(t) - x;
+
+        if (std::fabs(diff) < 1e-7f) {
+            break;
+        }
+
+        if (diff > 0) {
+            b = t;
+        } else {
+            a = t;
+        }
+    }
+
+    return t;
+}
+
+/**
+ * Apply time function.
+ */
+float CubicBezierEasing::apply(float t) {
+    if (linear || t <= 0 || t >= 1) {
+        return t;
+    }
+
+    return sampleY(solveT(t));
+}
+
+//
+// SpringEasing
+//
+
+/**
+ * Constructor.
+ *
+ * @param stiffness spring constant.
+ * @param damping damping coefficient.
+ * @param mass mass.
+ * @param velocity initial velocity (distance per second, distance is 1).
+ * @param duration animation duration in milliseconds.
+ */
+SpringEasing::SpringEasing(float stiffness, float damping, float mass, float velocity, float duration): duration(duration / 1000.f), velocity(velocity) {
+    omega0 = std::sqrt(stiffness / mass);
+    zeta = damping / (2 * std::sqrt(stiffness * mass));
+}
+
+/**
+ * Apply time function.
+ */
+float SpringEasing::apply(float t) {
+    if (t <= 0) {
+        return 0;
+    }
+
+    //displacement from the end position
+    float time = t * duration;
+    float x0 = -1;
+    float x;
+
+    if (zeta < 0.999f) {
+        //underdamped
+        float omegaD = omega0 * std::sqrt(1 - zeta * zeta);
+
+        x = std::exp(-zeta * omega0 * time) * (x0 * std::cos(omegaD * time) + (velocity + zeta * omega0 * x0) / omegaD * std::sin(omegaD * time));
+    } else if (zeta <= 1.001f) {
+        //critically damped
+        x = std::exp(-omega0 * time) * (x0 + (velocity + omega0 * x0) * time);
+    } else {
+        //overdamped
+        float root = std::sqrt(zeta * zeta - 1);
+        float r1 = -omega0 * (zeta - root);
+        float r2 = -omega0 * (zeta + root);
+        float c2 = (velocity - r1 * x0) / (r2 - r1);
+        float c1 = x0 - c2;
+
+        x = c1 * std::exp(r1 * time) + c2 * std::exp(r2 * time);
+    }
+
+    return 1 + x;
+}
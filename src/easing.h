@@ -0,0 +1,72 @@
+#ifndef _AMINOEASING_H
+#define _AMINOEASING_H
+
+#include <string>
+
+/**
+ * Parametric time function.
+ *
+ * Note: the built-in time functions (linear, cubic) are handled by AminoAnim.
+ */
+class AminoEasing {
+public:
+    virtual ~AminoEasing();
+
+    virtual float apply(float t) = 0;
+
+    static AminoEasing* parse(const std::string &str, float duration);
+};
+
+/**
+ * CSS cubic-bezier() time function.
+ *
+ * Control points P0 = (0, 0) and P3 = (1, 1) are implicit.
+ */
+class CubicBezierEasing : public AminoEasing {
+public:
+    CubicBezierEasing(float x1, float y1, float x2, float y2);
+
+    float apply(float t) override;
+
+private:
+    static const int SAMPLE_COUNT = 11;
+    static const int NEWTON_ITERATIONS = 4;
+    static const int SUBDIVISION_ITERATIONS = 10;
+
+    bool linear;
+
+    //polynomial coefficients
+    float ax, bx, cx;
+    float ay, by, cy;
+
+    //x values at equidistant t values
+    float samples[SAMPLE_COUNT];
+
+    float sampleX(float t);
+    float sampleY(float t);
+    float sampleDerivativeX(float t);
+    float solveT(float x);
+};
+
+/**
+ * Damped spring time function.
+ *
+ * Moves from 0 to 1 with the closed-form solution of a damped harmonic oscillator (underdamped, critically damped or
+ * overdamped). Time is measured in seconds.
+ */
+class SpringEasing : public AminoEasing {
+public:
+    SpringEasing(float stiffness, float damping, float mass, float velocity, float duration);
+
+    float apply(float t) override;
+
+private:
+    //duration in seconds
+    float duration;
+
+    float omega0;
+    float zeta;
+    float velocity;
+};
+
+#endif
@@ -4,10 +4,20 @@
 #include "fonts/shader.h"
 #include "base.h"
 
+#include <algorithm>
 #include <cmath>
+#include <climits>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define DEBUG_FONTS false
 
+//max glyph rendering threads
+#define PRELOAD_MAX_THREADS 4
+
 //
 // AminoFonts
 //
@@ -75,18 +85,116 @@ AminoJSObject* AminoFontsFactory::create() {
     return new AminoFonts();
 }
 
+//
+// AminoFontFile
+//
+
+AminoFontFile::AminoFontFile(const std::string &path, const char *data, size_t size): data(data), size(size), path(path) {
+    //empty
+}
+
+AminoFontFile::~AminoFontFile() {
+    munmap((void *)data, size);
+}
+
+/**
+ * Map a font file (or use the already mapped file).
+ *
+ * Returns NULL on error.
+ */
+AminoFontFile *AminoFontFile::open(const std::string &path) {
+    //real path (same file with different paths)
+    char resolved[PATH_MAX];
+
+    if (!realpath(path.c_str(), resolved)) {
+        return NULL;
+    }
+
+    std::string key(resolved);
+    std::map<std::string, AminoFontFile *>::iterator it = files.find(key);
+
+    if (it != files.end()) {
+        it->second->refs++;
+
+        return it->second;
+    }
+
+    //map file (Note: descriptor not needed after mmap())
+    int fd = ::open(resolved, O_RDONLY);
+
+    if (fd == -1) {
+        return NULL;
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+
+        return NULL;
+    }
+
+    size_t size = st.st_size;
+    void *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    close(fd);
+
+    if (data == MAP_FAILED) {
+        return NULL;
+    }
+
+    //glyphs are accessed randomly (no read-ahead)
+    madvise(data, size, MADV_RANDOM);
+
+    AminoFontFile *file = new AminoFontFile(key, (const char *)data, size);
+
+    files[key] = file;
+
+    if (DEBUG_FONTS) {
+        printf("-> mapped font file: %s (%i bytes)\n", resolved, (int)size);
+    }
+
+    return file;
+}
+
+/**
+ * Release the file (unmapped if no longer used).
+ */
+void AminoFontFile::release() {
+    refs--;
+
+    if (refs > 0) {
+        return;
+    }
+
+    files.erase(path);
+
+    if (DEBUG_FONTS) {
+        printf("-> unmapped font file: %s\n", path.c_str());
+    }
+
+    delete this;
+}
+
+std::map<std::string, AminoFontFile *> AminoFontFile::files;
+
 //
 // AminoFont
 //
 
 AminoFont::AminoFont(): AminoJSObject(getFactory()->name) {
-    //empty
+    //mutex
+    int res = uv_mutex_init(&fontLock);
+
+    assert(res == 0);
 }
 
 AminoFont::~AminoFont() {
     if (!destroyed) {
         destroyAminoFont();
     }
+
+    uv_mutex_destroy(&fontLock);
 }
 
 /**
@@ -108,21 +216,65 @@ void AminoFont::destroy() {
  * Destroy font data.
  */
 void AminoFont::destroyAminoFont() {
+    //pending text layouts
+    AminoGfx::cancelFontLayouts(this);
+
     //font sizes
+    lock();
+
+    //cached layouts
+    AminoText::initTextCacheMutex();
+    uv_mutex_lock(&AminoText::textCacheMutex);
+
+    for (std::map<int, texture_font_t *>::iterator it = fontSizes.begin(); it != fontSizes.end(); it++) {
+        AminoText::textCache.removeFont(it->second);
+    }
+
+    if (sdfFont) {
+        AminoText::textCache.removeFont(sdfFont);
+    }
+
+    uv_mutex_unlock(&AminoText::textCacheMutex);
+
     for (std::map<int, texture_font_t *>::iterator it = fontSizes.begin(); it != fontSizes.end(); it++) {
         texture_font_delete(it->second);
     }
 
+    if (sdfFont) {
+        texture_font_delete(sdfFont);
+        sdfFont = NULL;
+    }
+
     fontSizes.clear();
 
+    //FreeType instance (after all faces are gone)
+    if (library) {
+        FT_Done_FreeType(library);
+        library = NULL;
+    }
+
+    unlock();
+
     //atlas
     if (atlas) {
         texture_atlas_delete(atlas);
         atlas = NULL;
     }
 
+    if (sdfAtlas) {
+        texture_atlas_delete(sdfAtlas);
+        sdfAtlas = NULL;
+    }
+
     //font data
+    if (fontFile) {
+        fontFile->release();
+        fontFile = NULL;
+    }
+
     fontData.Reset();
+    fontBuffer = NULL;
+    fontBufferLen = 0;
 }
 
 /**
@@ -144,7 +296,8 @@ AminoFontFactory* AminoFont::getFactory() {
 v8::Local<v8::FunctionTemplate> AminoFont::GetInitFunction() {
     v8::Local<v8::FunctionTemplate> tpl = AminoJSObject::createTemplate(getFactory());
 
-    //no methods
+    //methods
+    Nan::SetPrototypeMethod(tpl, "_getStats", GetStats);
 
     //template function
     return tpl;
@@ -157,6 +310,49 @@ NAN_METHOD(AminoFont::New) {
     AminoJSObject::createInstance(info, getFactory());
 }
 
+/**
+ * Get atlas statistics (pages, fill ratio, loaded sizes).
+ */
+NAN_METHOD(AminoFont::GetStats) {
+    AminoFont *obj = Nan::ObjectWrap::Unwrap<AminoFont>(info.This());
+
+    assert(obj);
+
+    //atlas pages
+    int pages = 0;
+    double used = 0;
+    double total = 0;
+
+    obj->lock();
+
+    for (texture_atlas_t *atlas = obj->atlas; atlas; atlas = atlas->next) {
+        pages++;
+        used += atlas->used;
+        total += atlas->width * atlas->height;
+    }
+
+    int sdfPages = 0;
+
+    for (texture_atlas_t *atlas = obj->sdfAtlas; atlas; atlas = atlas->next) {
+        sdfPages++;
+    }
+
+    uint32_t sizes = (uint32_t)obj->fontSizes.size();
+
+    obj->unlock();
+
+    //result
+    v8::Local<v8::Object> statsObj = Nan::New<v8::Object>();
+
+    Nan::Set(statsObj, Nan::New("pages").ToLocalChecked(), Nan::New<v8::Int32>(pages));
+    Nan::Set(statsObj, Nan::New("fill").ToLocalChecked(), Nan::New<v8::Number>(total > 0 ? used / total : 0));
+    Nan::Set(statsObj, Nan::New("sizes").ToLocalChecked(), Nan::New<v8::Uint32>(sizes));
+    Nan::Set(statsObj, Nan::New("sdfPages").ToLocalChecked(), Nan::New<v8::Int32>(sdfPages));
+    Nan::Set(statsObj, Nan::New("mapped").ToLocalChecked(), Nan::New<v8::Boolean>(obj->fontFile != NULL));
+
+    info.GetReturnValue().Set(statsObj);
+}
+
 /**
  * Initialize fonts instance.
  */
@@ -170,10 +366,34 @@ void AminoFont::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
 
     this->fonts = fonts;
 
-    //store font (in memory)
-    v8::Local<v8::Object> bufferObj =  Nan::Get(fontData, Nan::New<v8::String>("data").ToLocalChecked()).ToLocalChecked()->ToObject();
+    //font data (mapped file or buffer)
+    v8::Local<v8::Value> fileValue = Nan::Get(fontData, Nan::New<v8::String>("file").ToLocalChecked()).ToLocalChecked();
+    v8::Local<v8::Value> dataValue = Nan::Get(fontData, Nan::New<v8::String>("data").ToLocalChecked()).ToLocalChecked();
+
+    if (node::Buffer::HasInstance(dataValue)) {
+        //keep buffer
+        v8::Local<v8::Object> bufferObj = dataValue->ToObject();
+
+        this->fontData.Reset(bufferObj);
+        fontBuffer = node::Buffer::Data(bufferObj);
+        fontBufferLen = node::Buffer::Length(bufferObj);
+    } else if (fileValue->IsString()) {
+        //map file (shared by all fonts)
+        std::string file = AminoJSObject::toString(fileValue);
 
-    this->fontData.Reset(bufferObj);
+        fontFile = AminoFontFile::open(file);
+
+        if (!fontFile) {
+            Nan::ThrowTypeError(("could not map font file: " + file).c_str());
+            return;
+        }
+
+        fontBuffer = fontFile->data;
+        fontBufferLen = fontFile->size;
+    } else {
+        Nan::ThrowTypeError("missing font data");
+        return;
+    }
 
     //create atlas
     atlas = texture_atlas_new(512, 512, 1); //depth must be 1
@@ -183,6 +403,18 @@ void AminoFont::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
         return;
     }
 
+    //additional pages (Note: 2048 is the maximum texture size on the Raspberry Pi)
+    atlas->max_size = 2048;
+    atlas->owner = this;
+
+    //own FreeType instance (fonts can be used in parallel)
+    if (FT_Init_FreeType(&library)) {
+        library = NULL;
+
+        Nan::ThrowTypeError("could not initialize FreeType");
+        return;
+    }
+
     //metadata
     v8::Local<v8::Value> nameValue = Nan::Get(fontData, Nan::New<v8::String>("name").ToLocalChecked()).ToLocalChecked();
     v8::Local<v8::Value> styleValue = Nan::Get(fontData, Nan::New<v8::String>("style").ToLocalChecked()).ToLocalChecked();
@@ -207,21 +439,17 @@ texture_font_t *AminoFont::getFontWithSize(int size) {
     texture_font_t *fontSize;
 
     if (it == fontSizes.end()) {
-        //add new size
-        v8::Local<v8::Object> bufferObj = Nan::New(fontData);
-        char *buffer = node::Buffer::Data(bufferObj);
-        size_t bufferLen = node::Buffer::Length(bufferObj);
+        //add new size (Note: has texture id but we use our own handling)
+        lock();
 
-        //Note: has texture id but we use our own handling
-        fontSize = texture_font_new_from_memory(atlas, size, buffer, bufferLen, library);
+        fontSize = texture_font_new_from_memory(atlas, size, fontBuffer, fontBufferLen, library);
 
         if (fontSize) {
             fontSizes[size] = fontSize;
-
-            //use single FreeType instance
-            library = fontSize->library;
         }
 
+        unlock();
+
         if (DEBUG_FONTS) {
             printf("-> new font size: %i (%s)\n", size, getFontInfo().c_str());
         }
@@ -232,6 +460,46 @@ texture_font_t *AminoFont::getFontWithSize(int size) {
     return fontSize;
 }
 
+/**
+ * Get the signed distance field font (single size for all font sizes).
+ *
+ * Note: has to be called in v8 thread.
+ */
+texture_font_t *AminoFont::getSdfFont() {
+    if (sdfFont) {
+        return sdfFont;
+    }
+
+    //own atlas (distance values instead of coverage)
+    if (!sdfAtlas) {
+        sdfAtlas = texture_atlas_new(512, 512, 1);
+
+        if (!sdfAtlas) {
+            return NULL;
+        }
+
+        sdfAtlas->max_size = 2048;
+        sdfAtlas->owner = this;
+    }
+
+    lock();
+
+    sdfFont = texture_font_new_from_memory(sdfAtlas, SDF_BASE_SIZE, fontBuffer, fontBufferLen, library);
+
+    if (sdfFont) {
+        //Note: set before any glyph is loaded
+        sdfFont->rendermode = RENDER_SIGNED_DISTANCE_FIELD;
+    }
+
+    unlock();
+
+    if (DEBUG_FONTS) {
+        printf("-> new SDF font: %s\n", getFontInfo().c_str());
+    }
+
+    return sdfFont;
+}
+
 /**
  * Get Unique font info string.
  */
@@ -239,7 +507,32 @@ std::string AminoFont::getFontInfo() {
     return fontName + "/" + fontStyle + "/" + std::to_string(fontWeight);
 }
 
-FT_Library AminoFont::library = NULL;
+/**
+ * Lock the font (FreeType face, atlas and glyphs).
+ *
+ * Note: different fonts can be used in parallel.
+ */
+void AminoFont::lock() {
+    uv_mutex_lock(&fontLock);
+}
+
+/**
+ * Unlock the font.
+ */
+void AminoFont::unlock() {
+    uv_mutex_unlock(&fontLock);
+}
+
+/**
+ * Get the lock of the font owning the atlas.
+ */
+uv_mutex_t *AminoFont::getAtlasLock(texture_atlas_t *atlas) {
+    AminoFont *font = (AminoFont *)atlas->owner;
+
+    assert(font);
+
+    return &font->fontLock;
+}
 
 //
 //  AminoFontFactory
@@ -259,6 +552,223 @@ AminoJSObject* AminoFontFactory::create() {
     return new AminoFont();
 }
 
+//
+// AsyncPreloadWorker
+//
+
+/**
+ * Glyphs rendered by a single thread.
+ */
+typedef struct {
+    texture_font_t *font;
+    std::vector<uint32_t> codepoints;
+    std::vector<texture_glyph_bitmap_t> bitmaps;
+} preload_slice_t;
+
+/**
+ * Asynchronous glyph loader.
+ *
+ * Renders the glyphs in parallel (own FreeType instance per thread) and packs them into the atlas afterwards.
+ */
+class AsyncPreloadWorker : public Nan::AsyncWorker {
+private:
+    texture_font_t *font;
+    std::vector<uint32_t> codepoints;
+
+    //result
+    uint32_t loaded = 0;
+
+public:
+    AsyncPreloadWorker(Nan::Callback *callback, v8::Local<v8::Object> &obj, AminoFontSize *fontSize, Nan::Utf8String &chars) : AsyncWorker(callback) {
+        //keep font (and font data) alive
+        SaveToPersistent("object", obj);
+        SaveToPersistent("font", fontSize->font->handle());
+
+        font = fontSize->fontTexture;
+
+        //distinct codepoints
+        const char *pos = *chars;
+        const char *end = pos + chars.length();
+
+        while (pos < end) {
+            uint32_t codepoint = utf8_to_utf32(pos);
+
+            if (codepoint) {
+                codepoints.push_back(codepoint);
+            }
+
+            pos += utf8_surrogate_len(pos);
+        }
+
+        std::sort(codepoints.begin(), codepoints.end());
+        codepoints.erase(std::unique(codepoints.begin(), codepoints.end()), codepoints.end());
+    }
+
+    /**
+     * Async running code.
+     */
+    void Execute() {
+        //missing glyphs
+        std::vector<uint32_t> missing;
+        uv_mutex_t *fontLock = AminoFont::getAtlasLock(font->atlas);
+
+        uv_mutex_lock(fontLock);
+
+        for (auto codepoint : codepoints) {
+            if (!texture_font_find_glyph_utf32(font, codepoint)) {
+                missing.push_back(codepoint);
+            }
+        }
+
+        uv_mutex_unlock(fontLock);
+
+        if (missing.empty()) {
+            return;
+        }
+
+        //threads
+        uv_cpu_info_t *cpus;
+        int cpuCount = 1;
+
+        if (uv_cpu_info(&cpus, &cpuCount) == 0) {
+            uv_free_cpu_info(cpus, cpuCount);
+        }
+
+        std::size_t threadCount = std::max(1, std::min(cpuCount, PRELOAD_MAX_THREADS));
+
+        //at least 16 glyphs per thread
+        threadCount = std::min(threadCount, (missing.size() + 15) / 16);
+
+        if (DEBUG_FONTS) {
+            printf("-> preloading %i glyphs (%i threads)\n", (int)missing.size(), (int)threadCount);
+        }
+
+        //render (interleaved to balance the load)
+        std::vector<preload_slice_t> slices(threadCount);
+        std::vector<uv_thread_t> threads(threadCount);
+
+        for (std::size_t i = 0; i < missing.size(); i++) {
+            slices[i % threadCount].codepoints.push_back(missing[i]);
+        }
+
+        std::vector<bool> started(threadCount, false);
+
+        for (std::size_t i = 0; i < threadCount; i++) {
+            slices[i].font = font;
+
+            if (i > 0) {
+                started[i] = uv_thread_create(&threads[i], renderGlyphs, &slices[i]) == 0;
+            }
+        }
+
+        //Note: first slice and slices without a thread on this thread
+        for (std::size_t i = 0; i < threadCount; i++) {
+            if (!started[i]) {
+                renderGlyphs(&slices[i]);
+            }
+        }
+
+        for (std::size_t i = 1; i < threadCount; i++) {
+            if (started[i]) {
+                uv_thread_join(&threads[i]);
+            }
+        }
+
+        //pack (tallest first to reduce fragmentation)
+        std::vector<texture_glyph_bitmap_t> bitmaps;
+
+        for (auto const &slice : slices) {
+            bitmaps.insert(bitmaps.end(), slice.bitmaps.begin(), slice.bitmaps.end());
+        }
+
+        std::sort(bitmaps.begin(), bitmaps.end(), [](const texture_glyph_bitmap_t &a, const texture_glyph_bitmap_t &b) {
+            return a.height > b.height;
+        });
+
+        bool full = false;
+
+        uv_mutex_lock(fontLock);
+
+        for (auto &bitmap : bitmaps) {
+            //Note: glyph might have been loaded by the rendering thread in the meantime
+            if (!full && !texture_font_find_glyph_utf32(font, bitmap.codepoint)) {
+                if (texture_font_pack_glyph(font, &bitmap)) {
+                    loaded++;
+                } else {
+                    full = true;
+                }
+            }
+
+            free(bitmap.buffer);
+        }
+
+        uv_mutex_unlock(fontLock);
+
+        if (full) {
+            SetErrorMessage("texture atlas is full");
+        }
+    }
+
+    /**
+     * Render glyphs (own FreeType instance).
+     */
+    static void renderGlyphs(void *arg) {
+        preload_slice_t *slice = (preload_slice_t *)arg;
+        FT_Library library;
+        FT_Face face;
+
+        if (FT_Init_FreeType(&library)) {
+            return;
+        }
+
+        if (texture_font_new_face(slice->font, library, &face)) {
+            for (auto codepoint : slice->codepoints) {
+                texture_glyph_bitmap_t bitmap;
+
+                if (texture_font_render_glyph(slice->font, library, face, codepoint, &bitmap)) {
+                    slice->bitmaps.push_back(bitmap);
+                }
+            }
+
+            FT_Done_Face(face);
+        }
+
+        FT_Done_FreeType(library);
+    }
+
+    /**
+     * Upload the atlas and call the callback.
+     */
+    void HandleOKCallback() {
+        updateTextures();
+
+        //call callback
+        v8::Local<v8::Value> argv[] = { Nan::Null(), Nan::New<v8::Uint32>(loaded) };
+
+        Nan::Call(*callback, 2, argv);
+    }
+
+    /**
+     * Upload the packed glyphs (atlas full) and call the callback.
+     */
+    void HandleErrorCallback() {
+        updateTextures();
+
+        AsyncWorker::HandleErrorCallback();
+    }
+
+    /**
+     * Update the font textures of all instances (all pages).
+     */
+    void updateTextures() {
+        if (loaded > 0) {
+            for (texture_atlas_t *atlas = font->atlas; atlas; atlas = atlas->next) {
+                AminoGfx::updateAtlasTextures(atlas);
+            }
+        }
+    }
+};
+
 //
 // AminoFontSize
 //
@@ -293,6 +803,7 @@ v8::Local<v8::FunctionTemplate> AminoFontSize::GetInitFunction() {
     //methods
     Nan::SetPrototypeMethod(tpl, "_calcTextWidth", CalcTextWidth);
     Nan::SetPrototypeMethod(tpl, "getFontMetrics", GetFontMetrics);
+    Nan::SetPrototypeMethod(tpl, "_preload", Preload);
 
     //template function
     return tpl;
@@ -309,15 +820,24 @@ NAN_METHOD(AminoFontSize::New) {
  * Initialize constructor values.
  */
 void AminoFontSize::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
-    assert(info.Length() == 2);
+    assert(info.Length() >= 2);
 
     AminoFont *font = Nan::ObjectWrap::Unwrap<AminoFont>(info[0]->ToObject());
-    int size = (int)round(info[1]->NumberValue());
+    double size = info[1]->NumberValue();
 
     assert(font);
 
     this->font = font;
-    fontTexture = font->getFontWithSize(size);
+    sdf = info.Length() > 2 && info[2]->BooleanValue();
+
+    if (sdf) {
+        //any size
+        fontTexture = font->getSdfFont();
+        scale = size / AminoFont::SDF_BASE_SIZE;
+    } else {
+        size = round(size);
+        fontTexture = font->getFontWithSize((int)size);
+    }
 
     if (!fontTexture) {
         Nan::ThrowTypeError("could not create font size");
@@ -330,6 +850,7 @@ void AminoFontSize::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
     Nan::Set(obj, Nan::New("size").ToLocalChecked(), Nan::New<v8::Number>(size));
     Nan::Set(obj, Nan::New("weight").ToLocalChecked(), Nan::New<v8::Number>(font->fontWeight));
     Nan::Set(obj, Nan::New("style").ToLocalChecked(), Nan::New<v8::String>(font->fontStyle).ToLocalChecked());
+    Nan::Set(obj, Nan::New("sdf").ToLocalChecked(), Nan::New<v8::Boolean>(sdf));
 }
 
 /**
@@ -355,8 +876,7 @@ float AminoFontSize::getTextWidth(const char *text) {
     char *lastTextPos = NULL;
     float w = 0;
 
-    AminoText::initFreeTypeMutex();
-    uv_mutex_lock(&AminoText::freeTypeMutex);
+    font->lock();
 
     size_t lastGlyphCount = fontTexture->glyphs->size;
 
@@ -370,7 +890,7 @@ float AminoFontSize::getTextWidth(const char *text) {
 
         //kerning
         if (lastTextPos) {
-            w += texture_glyph_get_kerning(glyph, lastTextPos);
+            w += texture_font_get_kerning(fontTexture, lastTextPos, textPos);
         }
 
         //char width
@@ -385,16 +905,16 @@ float AminoFontSize::getTextWidth(const char *text) {
 
     bool glyphsChanged = lastGlyphCount != fontTexture->glyphs->size;
 
-    uv_mutex_unlock(&AminoText::freeTypeMutex);
+    font->unlock();
 
     if (glyphsChanged) {
-        texture_atlas_t *atlas = fontTexture->atlas;
-
-        //update all instances
-        AminoGfx::updateAtlasTextures(atlas);
+        //update all instances (all pages)
+        for (texture_atlas_t *atlas = fontTexture->atlas; atlas; atlas = atlas->next) {
+            AminoGfx::updateAtlasTextures(atlas);
+        }
     }
 
-    return w;
+    return w * scale;
 }
 
 /**
@@ -408,13 +928,30 @@ NAN_METHOD(AminoFontSize::GetFontMetrics) {
     //metrics
     v8::Local<v8::Object> metricsObj = Nan::New<v8::Object>();
 
-    Nan::Set(metricsObj, Nan::New("height").ToLocalChecked(), Nan::New<v8::Number>(obj->fontTexture->ascender - obj->fontTexture->descender));
-    Nan::Set(metricsObj, Nan::New("ascender").ToLocalChecked(), Nan::New<v8::Number>(obj->fontTexture->ascender));
-    Nan::Set(metricsObj, Nan::New("descender").ToLocalChecked(), Nan::New<v8::Number>(obj->fontTexture->descender));
+    Nan::Set(metricsObj, Nan::New("height").ToLocalChecked(), Nan::New<v8::Number>((obj->fontTexture->ascender - obj->fontTexture->descender) * obj->scale));
+    Nan::Set(metricsObj, Nan::New("ascender").ToLocalChecked(), Nan::New<v8::Number>(obj->fontTexture->ascender * obj->scale));
+    Nan::Set(metricsObj, Nan::New("descender").ToLocalChecked(), Nan::New<v8::Number>(obj->fontTexture->descender * obj->scale));
 
     info.GetReturnValue().Set(metricsObj);
 }
 
+/**
+ * Load glyphs asynchronously.
+ */
+NAN_METHOD(AminoFontSize::Preload) {
+    assert(info.Length() == 2);
+
+    AminoFontSize *obj = Nan::ObjectWrap::Unwrap<AminoFontSize>(info.This());
+    Nan::Utf8String chars(info[0]);
+    Nan::Callback *callback = new Nan::Callback(info[1].As<v8::Function>());
+    v8::Local<v8::Object> handle = info.This();
+
+    assert(obj);
+
+    //async loading
+    AsyncQueueWorker(new AsyncPreloadWorker(callback, handle, obj, chars));
+}
+
 //
 //  AminoFontSizeFactory
 //
@@ -440,22 +977,39 @@ AminoJSObject* AminoFontSizeFactory::create() {
 AminoFontShader::AminoFontShader() : TextureShader() {
     //shader
 
-    //Note: using unmodified vertex shader
+    //Note: color contains the opacity
+    vertexShader = R"(
+        uniform mat4 mvp;
+        uniform mat4 trans;
+
+        attribute vec4 pos;
+        attribute vec2 texCoord;
+        attribute vec4 color;
+
+        varying vec2 uv;
+        varying vec4 vColor;
+
+        void main() {
+            gl_Position = mvp * trans * pos;
+            uv = texCoord;
+            vColor = color;
+        }
+    )";
+
     fragmentShader = R"(
         #ifdef GL_ES
             precision mediump float;
         #endif
 
-        uniform float opacity;
-        uniform vec3 color;
         uniform sampler2D tex;
 
         varying vec2 uv;
+        varying vec4 vColor;
 
         void main() {
             float a = texture2D(tex, uv).a;
 
-            gl_FragColor = vec4(color, opacity * a);
+            gl_FragColor = vec4(vColor.rgb, vColor.a * a);
         }
     )";
 }
@@ -466,15 +1020,30 @@ AminoFontShader::AminoFontShader() : TextureShader() {
 void AminoFontShader::initShader() {
     TextureShader::initShader();
 
-    //uniforms
-    uColor = getUniformLocation("color");
+    //attributes
+    aColor = getAttributeLocation("color");
+}
+
+/**
+ * Set interleaved vertex data (x/y/z/s/t/r/g/b/a).
+ */
+void AminoFontShader::setBatchData(GLfloat *vertices) {
+    GLsizei stride = BATCH_VERTEX_SIZE * sizeof(GLfloat);
+
+    glVertexAttribPointer(aPos, 3, GL_FLOAT, GL_FALSE, stride, vertices);
+    glVertexAttribPointer(aTexCoord, 2, GL_FLOAT, GL_FALSE, stride, vertices + 3);
+    glVertexAttribPointer(aColor, 4, GL_FLOAT, GL_FALSE, stride, vertices + 5);
 }
 
 /**
- * Set color.
+ * Draw elements.
  */
-void AminoFontShader::setColor(GLfloat color[3]) {
-    glUniform3f(uColor, color[0], color[1], color[2]);
+void AminoFontShader::drawElements(GLushort *indices, GLsizei elements, GLenum mode) {
+    glEnableVertexAttribArray(aColor);
+
+    TextureShader::drawElements(indices, elements, mode);
+
+    glDisableVertexAttribArray(aColor);
 }
 
 /**
@@ -520,6 +1089,8 @@ amino_atlas_t AminoFontShader::getAtlasTexture(texture_atlas_t *atlas, bool crea
         amino_atlas_t item;
 
         item.textureId = id;
+        item.uploaded = false;
+        item.version = 0;
 
         atlasTextures[atlas] = item;
 
@@ -531,3 +1102,65 @@ amino_atlas_t AminoFontShader::getAtlasTexture(texture_atlas_t *atlas, bool crea
 
     return it->second;
 }
+
+/**
+ * Upload the modified atlas data to the texture.
+ *
+ * Returns true if data was uploaded.
+ *
+ * Note: has to be called on OpenGL thread.
+ */
+bool AminoFontShader::updateAtlasTexture(texture_atlas_t *atlas) {
+    std::map<texture_atlas_t *, amino_atlas_t>::iterator it = atlasTextures.find(atlas);
+
+    if (it == atlasTextures.end()) {
+        return false;
+    }
+
+    return AminoText::updateTextureFromAtlas(it->second, atlas);
+}
+
+//
+// AminoFontSdfShader
+//
+
+AminoFontSdfShader::AminoFontSdfShader() : AminoFontShader() {
+    //shader
+
+    //Note: edge at 0.5, smoothing depends on the scale
+    fragmentShader = R"(
+        #ifdef GL_ES
+            precision mediump float;
+        #endif
+
+        uniform float smoothing;
+        uniform sampler2D tex;
+
+        varying vec2 uv;
+        varying vec4 vColor;
+
+        void main() {
+            float dist = texture2D(tex, uv).a;
+            float a = smoothstep(0.5 - smoothing, 0.5 + smoothing, dist);
+
+            gl_FragColor = vec4(vColor.rgb, vColor.a * a);
+        }
+    )";
+}
+
+/**
+ * Initialize the SDF font shader.
+ */
+void AminoFontSdfShader::initShader() {
+    AminoFontShader::initShader();
+
+    //uniforms
+    uSmoothing = getUniformLocation("smoothing");
+}
+
+/**
+ * Set edge smoothing (distance range of the anti-aliased edge).
+ */
+void AminoFontSdfShader::setSmoothing(GLfloat smoothing) {
+    glUniform1f(uSmoothing, smoothing);
+}
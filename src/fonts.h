@@ -41,6 +41,30 @@ public:
     AminoJSObject* create() override;
 };
 
+/**
+ * Memory-mapped font file (shared by all fonts using the same file).
+ *
+ * Note: pages are loaded on demand, has to be used on v8 thread.
+ */
+class AminoFontFile {
+public:
+    const char *data = NULL;
+    size_t size = 0;
+
+    static AminoFontFile *open(const std::string &path);
+    void release();
+
+private:
+    std::string path;
+    int refs = 1;
+
+    //mapped files (by real path)
+    static std::map<std::string, AminoFontFile *> files;
+
+    AminoFontFile(const std::string &path, const char *data, size_t size);
+    ~AminoFontFile();
+};
+
 class AminoFontFactory;
 
 /**
@@ -56,8 +80,17 @@ public:
     ~AminoFont();
 
     texture_font_t *getFontWithSize(int size);
+    texture_font_t *getSdfFont();
     std::string getFontInfo();
 
+    void lock();
+    void unlock();
+
+    static uv_mutex_t *getAtlasLock(texture_atlas_t *atlas);
+
+    //SDF glyph size (scaled to all font sizes)
+    static const int SDF_BASE_SIZE = 48;
+
     //creation
     static AminoFontFactory* getFactory();
 
@@ -65,20 +98,34 @@ public:
     static v8::Local<v8::FunctionTemplate> GetInitFunction();
 
 private:
-    //Note: instance kept
-    static FT_Library library;
+    //FreeType instance (shared by all sizes of this font)
+    FT_Library library = NULL;
+
+    //guards FreeType, the atlases and the font sizes of this font
+    uv_mutex_t fontLock;
 
     //JS constructor
     static NAN_METHOD(New);
 
     void preInit(Nan::NAN_METHOD_ARGS_TYPE info) override;
 
+    static NAN_METHOD(GetStats);
+
 protected:
     AminoFonts *fonts = NULL;
     texture_atlas_t *atlas = NULL;
+
+    //font data (mapped file or buffer)
+    AminoFontFile *fontFile = NULL;
     Nan::Persistent<v8::Object> fontData;
+    const char *fontBuffer = NULL;
+    size_t fontBufferLen = 0;
     std::map<int, texture_font_t *> fontSizes;
 
+    //signed distance field
+    texture_atlas_t *sdfAtlas = NULL;
+    texture_font_t *sdfFont = NULL;
+
     void destroy() override;
     void destroyAminoFont();
 };
@@ -103,6 +150,10 @@ public:
     texture_font_t *fontTexture = NULL;
     AminoFont *font = NULL;
 
+    //SDF font (glyphs of the base size scaled by the factor)
+    bool sdf = false;
+    float scale = 1;
+
     AminoFontSize();
     ~AminoFontSize();
 
@@ -121,6 +172,7 @@ private:
     //JS methods
     static NAN_METHOD(CalcTextWidth);
     static NAN_METHOD(GetFontMetrics);
+    static NAN_METHOD(Preload);
 
     void preInit(Nan::NAN_METHOD_ARGS_TYPE info) override;
 };
@@ -140,21 +192,44 @@ public:
  */
 struct amino_atlas_t {
     GLuint textureId;
+
+    //uploaded atlas data
+    bool uploaded;
+    size_t version;
 };
 
+/**
+ * Rendered glyphs of a single atlas page.
+ */
+typedef struct {
+    texture_atlas_t *atlas;
+    amino_atlas_t texture;
+    vertex_buffer_t *buffer;
+} amino_text_page_t;
+
 /**
  * Font Shader.
+ *
+ * Renders batches of text: per vertex position, texture coordinates and color (x/y/z/s/t/r/g/b/a).
  */
 class AminoFontShader : public TextureShader {
 public:
     AminoFontShader();
 
-    void setColor(GLfloat color[3]);
+    //per vertex data
+    void setBatchData(GLfloat *vertices);
+
+    //draw
+    void drawElements(GLushort *indices, GLsizei elements, GLenum mode) override;
 
     amino_atlas_t getAtlasTexture(texture_atlas_t *atlas, bool createIfMissing, bool &newTexture);
+    bool updateAtlasTexture(texture_atlas_t *atlas);
+
+    //vertex size
+    static const int BATCH_VERTEX_SIZE = 9;
 
 protected:
-    GLint uColor;
+    GLint aColor;
 
     //textures (Note: never destroyed)
     std::map<texture_atlas_t *, amino_atlas_t> atlasTextures;
@@ -162,4 +237,21 @@ protected:
     void initShader() override;
 };
 
+/**
+ * Signed distance field font shader.
+ *
+ * Note: atlas textures are managed by AminoFontShader.
+ */
+class AminoFontSdfShader : public AminoFontShader {
+public:
+    AminoFontSdfShader();
+
+    void setSmoothing(GLfloat smoothing);
+
+protected:
+    GLint uSmoothing;
+
+    void initShader() override;
+};
+
 #endif
\ No newline at end of file
@@ -38,6 +38,9 @@
 #include <limits.h>
 #include "texture-atlas.h"
 
+/* Maximum number of tracked regions (Addition to Freetype GL) */
+#define DIRTY_MAX 256
+
 
 // ------------------------------------------------------ texture_atlas_new ---
 texture_atlas_t *
@@ -64,6 +67,11 @@ texture_atlas_new( const size_t width,
     self->height = height;
     self->depth = depth;
     self->id = 0;
+    self->next = NULL;
+    self->max_size = width > height ? width : height;
+    self->owner = NULL;
+    self->dirty = vector_new( sizeof(ivec4) );
+    self->dirty_first = 0;
 
     vector_push_back( self->nodes, &node );
     self->data = (unsigned char *)
@@ -85,7 +93,12 @@ void
 texture_atlas_delete( texture_atlas_t *self )
 {
     assert( self );
+    if( self->next )
+    {
+        texture_atlas_delete( self->next );
+    }
     vector_delete( self->nodes );
+    vector_delete( self->dirty );
     if( self->data )
     {
         free( self->data );
@@ -94,6 +107,28 @@ texture_atlas_delete( texture_atlas_t *self )
 }
 
 
+// ------------------------------------------------ texture_atlas_add_dirty ---
+static void
+texture_atlas_add_dirty( texture_atlas_t * self,
+                         const size_t x,
+                         const size_t y,
+                         const size_t width,
+                         const size_t height )
+{
+    ivec4 region = {{x, y, width, height}};
+    size_t count = vector_size( self->dirty );
+
+    /* Keep the latest regions only (older versions need a full upload) */
+    if( count >= DIRTY_MAX )
+    {
+        vector_erase_range( self->dirty, 0, count / 2 );
+        self->dirty_first += count / 2;
+    }
+
+    vector_push_back( self->dirty, &region );
+}
+
+
 // ----------------------------------------------- texture_atlas_set_region ---
 void
 texture_atlas_set_region( texture_atlas_t * self,
@@ -123,6 +158,73 @@ texture_atlas_set_region( texture_atlas_t * self,
         memcpy( self->data+((y+i)*self->width + x ) * charsize * depth,
                 data + (i*stride) * charsize, width * charsize * depth  );
     }
+
+    texture_atlas_add_dirty( self, x, y, width, height );
+}
+
+
+// ---------------------------------------------- texture_atlas_get_version ---
+size_t
+texture_atlas_get_version( const texture_atlas_t * self )
+{
+    assert( self );
+
+    return self->dirty_first + vector_size( self->dirty );
+}
+
+
+// ------------------------------------------- texture_atlas_get_dirty_rows ---
+int
+texture_atlas_get_dirty_rows( const texture_atlas_t * self,
+                              const size_t version,
+                              vector_t * regions )
+{
+    size_t i, j, count;
+
+    assert( self );
+    assert( regions );
+
+    if( version < self->dirty_first )
+    {
+        return 0;
+    }
+
+    count = vector_size( self->dirty );
+    for( i = version - self->dirty_first; i < count; ++i )
+    {
+        const ivec4 * dirty = (const ivec4 *) vector_get( self->dirty, i );
+        int top = dirty->y;
+        int bottom = dirty->y + dirty->height;
+        int merged = 1;
+        ivec4 row;
+
+        /* Merge with overlapping or adjacent rows */
+        while( merged )
+        {
+            merged = 0;
+            for( j = 0; j < vector_size( regions ); ++j )
+            {
+                ivec4 * other = (ivec4 *) vector_get( regions, j );
+
+                if( other->y <= bottom && top <= other->y + other->height )
+                {
+                    top = top < other->y ? top : other->y;
+                    bottom = bottom > other->y + other->height ? bottom : other->y + other->height;
+                    vector_erase( regions, j );
+                    merged = 1;
+                    break;
+                }
+            }
+        }
+
+        row.x = 0;
+        row.y = top;
+        row.width = self->width;
+        row.height = bottom - top;
+        vector_push_back( regions, &row );
+    }
+
+    return 1;
 }
 
 
@@ -279,6 +381,54 @@ texture_atlas_get_region( texture_atlas_t * self,
 }
 
 
+// ------------------------------------------ texture_atlas_get_page_region ---
+texture_atlas_t *
+texture_atlas_get_page_region( texture_atlas_t * self,
+                               const size_t width,
+                               const size_t height,
+                               ivec4 * region )
+{
+    texture_atlas_t *page, *last = NULL;
+    size_t size;
+
+    assert( self );
+    assert( region );
+
+    /* Existing pages */
+    for( page = self; page; page = page->next )
+    {
+        *region = texture_atlas_get_region( page, width, height );
+        if( region->x >= 0 )
+        {
+            return page;
+        }
+        last = page;
+    }
+
+    /* New page (same size or large enough for the region, including the border) */
+    size = self->width > self->height ? self->width : self->height;
+    while( size < width + 2 || size < height + 2 )
+    {
+        size *= 2;
+    }
+
+    if( size > self->max_size )
+    {
+        return NULL;
+    }
+
+    page = texture_atlas_new( size, size, self->depth );
+    page->max_size = self->max_size;
+    page->owner = self->owner;
+    last->next = page;
+
+    *region = texture_atlas_get_region( page, width, height );
+    assert( region->x >= 0 );
+
+    return page;
+}
+
+
 // ---------------------------------------------------- texture_atlas_clear ---
 void
 texture_atlas_clear( texture_atlas_t * self )
@@ -296,4 +446,5 @@ texture_atlas_clear( texture_atlas_t * self )
 
     vector_push_back( self->nodes, &node );
     memset( self->data, 0, self->width*self->height*self->depth );
+    texture_atlas_add_dirty( self, 0, 0, self->width, self->height );
 }
@@ -136,6 +136,39 @@ typedef struct texture_atlas_t
      */
     unsigned char * data;
 
+    /**
+     * Next atlas page (or NULL).
+     *
+     * Addition to Freetype GL: a new page is added if a region does not fit
+     * into the existing pages.
+     */
+    struct texture_atlas_t * next;
+
+    /**
+     * Maximum size of an added page (defaults to the size of the atlas).
+     */
+    size_t max_size;
+
+    /**
+     * Owner of the atlas (copied to added pages).
+     *
+     * Addition to Freetype GL.
+     */
+    void * owner;
+
+    /**
+     * Modified regions (oldest first).
+     *
+     * Addition to Freetype GL: texture uploads are limited to the regions
+     * modified since the last upload.
+     */
+    vector_t * dirty;
+
+    /**
+     * Version of the first modified region (older ones were dropped).
+     */
+    size_t dirty_first;
+
 } texture_atlas_t;
 
 
@@ -156,7 +189,7 @@ typedef struct texture_atlas_t
 
 
 /**
- *  Deletes a texture atlas.
+ *  Deletes a texture atlas (including all pages).
  *
  *  @param self a texture atlas structure
  *
@@ -180,6 +213,27 @@ typedef struct texture_atlas_t
                             const size_t height );
 
 
+/**
+ *  Allocate a new region on any atlas page. A new page is added if the
+ *  region does not fit into the existing pages.
+ *
+ *  Addition to Freetype GL.
+ *
+ *  @param self   first page of the atlas
+ *  @param width  width of the region to allocate
+ *  @param height height of the region to allocate
+ *  @param region Coordinates of the allocated region
+ *  @return       atlas page of the region or NULL if the region is larger
+ *                than max_size
+ *
+ */
+  texture_atlas_t *
+  texture_atlas_get_page_region( texture_atlas_t * self,
+                                 const size_t width,
+                                 const size_t height,
+                                 ivec4 * region );
+
+
 /**
  *  Upload data to the specified atlas region.
  *
@@ -201,6 +255,39 @@ typedef struct texture_atlas_t
                             const unsigned char *data,
                             const size_t stride );
 
+/**
+ *  Get the current version of the atlas data (number of modified regions).
+ *
+ *  Addition to Freetype GL.
+ *
+ *  @param self   a texture atlas structure
+ *  @return       version
+ *
+ */
+  size_t
+  texture_atlas_get_version( const texture_atlas_t * self );
+
+
+/**
+ *  Get the rows modified since a version. Overlapping and adjacent regions
+ *  are coalesced. Each region spans the full atlas width (the data of a
+ *  region is contiguous).
+ *
+ *  Addition to Freetype GL.
+ *
+ *  @param self    a texture atlas structure
+ *  @param version version of the last upload
+ *  @param regions vector of ivec4 receiving the modified regions
+ *  @return        0 if the regions are no longer available (full upload
+ *                 needed), 1 otherwise
+ *
+ */
+  int
+  texture_atlas_get_dirty_rows( const texture_atlas_t * self,
+                                const size_t version,
+                                vector_t * regions );
+
+
 /**
  *  Remove all allocated regions from the atlas.
  *
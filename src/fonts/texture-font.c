@@ -50,6 +50,11 @@
 #define HRESf 64.f
 #define DPI   72
 
+#define GLYPH_TABLE_MIN   64
+#define KERNING_TABLE_MIN 64
+
+#define SDF_PADDING 4
+
 #undef __FTERRORS_H__
 #define FT_ERRORDEF( e, v, s )  { e, s },
 #define FT_ERROR_START_LIST     {
@@ -60,9 +65,16 @@ const struct {
 } FT_Errors[] =
 #include FT_ERRORS_H
 
-// ------------------------------------------------- texture_font_load_face ---
+// ------------------------------------------------- texture_font_open_face ---
+/*
+ * Open the font face with the given library.
+ *
+ * Addition to Freetype GL: separated from texture_font_load_face() to open
+ * additional faces (one per thread).
+ */
 static int
-texture_font_load_face(texture_font_t *self, float size)
+texture_font_open_face(texture_font_t *self, FT_Library library, float size,
+        FT_Face *face)
 {
     FT_Error error;
     FT_Matrix matrix = {
@@ -72,44 +84,31 @@ texture_font_load_face(texture_font_t *self, float size)
         (int)((1.0)      * 0x10000L)};
 
     assert(self);
+    assert(library);
     assert(size);
 
-    /* Initialize library */
-    if (!self->library) {
-        //printf("init FreeType instance\n");
-
-        error = FT_Init_FreeType(&self->library);
-        if(error) {
-            fprintf(stderr, "FT_Error (0x%02x) : %s\n",
-                    FT_Errors[error].code, FT_Errors[error].message);
-            goto cleanup;
-        }
-
-        assert(self->library);
-    }
-
     /* Load face */
     switch (self->location) {
     case TEXTURE_FONT_FILE:
-        error = FT_New_Face(self->library, self->filename, 0, &self->face);
+        error = FT_New_Face(library, self->filename, 0, face);
         break;
 
     case TEXTURE_FONT_MEMORY:
-        error = FT_New_Memory_Face(self->library,
-            self->memory.base, self->memory.size, 0, &self->face);
+        error = FT_New_Memory_Face(library,
+            self->memory.base, self->memory.size, 0, face);
         break;
     }
 
     if(error) {
         fprintf(stderr, "FT_Error (line %d, code 0x%02x) : %s\n",
                 __LINE__, FT_Errors[error].code, FT_Errors[error].message);
-        goto cleanup_library;
+        return 0;
     }
 
-    assert(self->face);
+    assert(*face);
 
     /* Select charmap */
-    error = FT_Select_Charmap(self->face, FT_ENCODING_UNICODE);
+    error = FT_Select_Charmap(*face, FT_ENCODING_UNICODE);
     if(error) {
         fprintf(stderr, "FT_Error (line %d, code 0x%02x) : %s\n",
                 __LINE__, FT_Errors[error].code, FT_Errors[error].message);
@@ -126,7 +125,7 @@ texture_font_load_face(texture_font_t *self, float size)
     float currSize = size;
 
     while (1) {
-        error = FT_Set_Pixel_Sizes(self->face, (int)(currSize * HRES), (int)currSize);
+        error = FT_Set_Pixel_Sizes(*face, (int)(currSize * HRES), (int)currSize);
 
         if (error) {
             fprintf(stderr, "FT_Error (line %d, code 0x%02x) : %s\n",
@@ -135,7 +134,7 @@ texture_font_load_face(texture_font_t *self, float size)
         }
 
         //check size
-        FT_Size_Metrics metrics = self->face->size->metrics;
+        FT_Size_Metrics metrics = (*face)->size->metrics;
         float ascender = metrics.ascender >> 6;
         float descender = metrics.descender >> 6;
         float height = ascender - descender;
@@ -157,7 +156,7 @@ texture_font_load_face(texture_font_t *self, float size)
 
     /* Set char size */
     /*
-    error = FT_Set_Char_Size(self->face, (int)(size * HRES), 0, DPI * HRES, DPI);
+    error = FT_Set_Char_Size(*face, (int)(size * HRES), 0, DPI * HRES, DPI);
 
     if(error) {
         fprintf(stderr, "FT_Error (line %d, code 0x%02x) : %s\n",
@@ -167,13 +166,46 @@ texture_font_load_face(texture_font_t *self, float size)
     */
 
     /* Set transform matrix */
-    FT_Set_Transform(self->face, &matrix, NULL);
+    FT_Set_Transform(*face, &matrix, NULL);
 
     return 1;
 
 cleanup_face:
-    FT_Done_Face( self->face );
-    self->face = NULL;
+    FT_Done_Face( *face );
+    *face = NULL;
+    return 0;
+}
+
+// ------------------------------------------------- texture_font_load_face ---
+static int
+texture_font_load_face(texture_font_t *self, float size)
+{
+    FT_Error error;
+
+    assert(self);
+    assert(size);
+
+    /* Initialize library */
+    if (!self->library) {
+        //printf("init FreeType instance\n");
+
+        error = FT_Init_FreeType(&self->library);
+        if(error) {
+            fprintf(stderr, "FT_Error (0x%02x) : %s\n",
+                    FT_Errors[error].code, FT_Errors[error].message);
+            goto cleanup;
+        }
+
+        assert(self->library);
+    }
+
+    /* Load face */
+    if (!texture_font_open_face(self, self->library, size, &self->face)) {
+        goto cleanup_library;
+    }
+
+    return 1;
+
 cleanup_library:
     if (!self->libraryShared) {
         FT_Done_FreeType( self->library );
@@ -183,6 +215,15 @@ cleanup:
     return 0;
 }
 
+// -------------------------------------------------- texture_font_new_face ---
+int
+texture_font_new_face(texture_font_t *self, FT_Library library, FT_Face *face)
+{
+    assert(self);
+
+    return texture_font_open_face(self, library, self->size, face);
+}
+
 // ------------------------------------------------------ texture_glyph_new ---
 texture_glyph_t *
 texture_glyph_new(void)
@@ -207,7 +248,7 @@ texture_glyph_new(void)
     self->t0        = 0.0;
     self->s1        = 0.0;
     self->t1        = 0.0;
-    self->kerning   = vector_new( sizeof(kerning_t) );
+    self->atlas     = NULL;
     return self;
 }
 
@@ -217,66 +258,276 @@ void
 texture_glyph_delete( texture_glyph_t *self )
 {
     assert( self );
-    vector_delete( self->kerning );
     free( self );
 }
 
-// ---------------------------------------------- texture_glyph_get_kerning ---
-float
-texture_glyph_get_kerning( const texture_glyph_t * self,
-                           const char * codepoint )
+/*
+ * Glyph & kerning hash tables.
+ *
+ * Addition to Freetype GL: open addressing with linear probing. Entries are
+ * never removed. The tables are grown at half load.
+ */
+
+// ---------------------------------------------------- texture_font_hash ---
+static inline uint32_t
+texture_font_hash( uint32_t key )
+{
+    key ^= key >> 16;
+    key *= 0x7feb352d;
+    key ^= key >> 15;
+    key *= 0x846ca68b;
+    key ^= key >> 16;
+    return key;
+}
+
+// ------------------------------------------------ texture_glyph_matches ---
+static inline int
+texture_glyph_matches( const texture_font_t *self,
+                       const texture_glyph_t *glyph,
+                       uint32_t ucodepoint )
+{
+    // If codepoint is -1, we don't care about outline type or thickness
+    return (glyph->codepoint == ucodepoint) &&
+           ((ucodepoint == UINT32_MAX) ||
+            ((glyph->rendermode == self->rendermode) &&
+             (glyph->outline_thickness == self->outline_thickness)));
+}
+
+// ---------------------------------------------- texture_glyph_table_put ---
+static void
+texture_glyph_table_put( texture_glyph_t **table, size_t size,
+                         texture_glyph_t *glyph )
+{
+    size_t mask = size - 1;
+    size_t i = texture_font_hash( glyph->codepoint ) & mask;
+
+    while( table[i] )
+    {
+        i = (i + 1) & mask;
+    }
+
+    table[i] = glyph;
+}
+
+// ------------------------------------------------- texture_font_add_glyph ---
+static void
+texture_font_add_glyph( texture_font_t *self, texture_glyph_t *glyph )
 {
     size_t i;
-    uint32_t ucodepoint = utf8_to_utf32( codepoint );
+
+    /* Grow hash table */
+    if( (self->glyphs->size + 1) * 2 > self->glyph_table_size )
+    {
+        size_t size = self->glyph_table_size ? self->glyph_table_size * 2 : GLYPH_TABLE_MIN;
+        texture_glyph_t **table = calloc( size, sizeof(texture_glyph_t *) );
+
+        assert( table );
+
+        for( i = 0; i < self->glyphs->size; ++i )
+        {
+            texture_glyph_table_put( table, size, *(texture_glyph_t **) vector_get( self->glyphs, i ) );
+        }
+
+        free( self->glyph_table );
+        self->glyph_table = table;
+        self->glyph_table_size = size;
+    }
+
+    vector_push_back( self->glyphs, &glyph );
+    texture_glyph_table_put( self->glyph_table, self->glyph_table_size, glyph );
+
+    /* ASCII & Latin-1 */
+    if( glyph->codepoint < 256 )
+    {
+        self->latin1_glyphs[glyph->codepoint] = glyph;
+    }
+}
+
+// -------------------------------------------- texture_font_kerning_hash ---
+static inline uint32_t
+texture_font_kerning_hash( uint32_t left, uint32_t right )
+{
+    return texture_font_hash( (left * 0x9e3779b1) ^ right );
+}
+
+// -------------------------------------------- texture_kerning_table_put ---
+static void
+texture_kerning_table_put( kerning_t *table, size_t size, const kerning_t *kerning )
+{
+    size_t mask = size - 1;
+    size_t i = texture_font_kerning_hash( kerning->left, kerning->right ) & mask;
+
+    while( table[i].left != UINT32_MAX )
+    {
+        i = (i + 1) & mask;
+    }
+
+    table[i] = *kerning;
+}
+
+// ----------------------------------------------- texture_font_add_kerning ---
+static void
+texture_font_add_kerning( texture_font_t *self, uint32_t left, uint32_t right,
+                          float value )
+{
+    size_t i;
+    kerning_t kerning = { left, right, value };
+
+    /* Already known (glyph with other render mode) */
+    if( self->kerning_count )
+    {
+        size_t mask = self->kerning_table_size - 1;
+
+        i = texture_font_kerning_hash( left, right ) & mask;
+
+        while( self->kerning_table[i].left != UINT32_MAX )
+        {
+            if( self->kerning_table[i].left == left && self->kerning_table[i].right == right )
+            {
+                self->kerning_table[i].kerning = value;
+                return;
+            }
+
+            i = (i + 1) & mask;
+        }
+    }
+
+    /* Grow hash table */
+    if( (self->kerning_count + 1) * 2 > self->kerning_table_size )
+    {
+        size_t size = self->kerning_table_size ? self->kerning_table_size * 2 : KERNING_TABLE_MIN;
+        kerning_t *table = malloc( size * sizeof(kerning_t) );
+
+        assert( table );
+
+        /* empty: left == -1 (never used by the special glyph) */
+        memset( table, 0xff, size * sizeof(kerning_t) );
+
+        for( i = 0; i < self->kerning_table_size; ++i )
+        {
+            if( self->kerning_table[i].left != UINT32_MAX )
+            {
+                texture_kerning_table_put( table, size, &self->kerning_table[i] );
+            }
+        }
+
+        free( self->kerning_table );
+        self->kerning_table = table;
+        self->kerning_table_size = size;
+    }
+
+    texture_kerning_table_put( self->kerning_table, self->kerning_table_size, &kerning );
+    self->kerning_count++;
+}
+
+// ----------------------------------------------- texture_font_get_kerning ---
+float
+texture_font_get_kerning( const texture_font_t * self,
+                          const char * left,
+                          const char * right )
+{
+    size_t i, mask;
+    uint32_t uleft, uright;
 
     assert( self );
-    for( i=0; i<vector_size(self->kerning); ++i )
+
+    if( !self->kerning_count )
+    {
+        return 0;
+    }
+
+    uleft = utf8_to_utf32( left );
+    uright = utf8_to_utf32( right );
+    mask = self->kerning_table_size - 1;
+    i = texture_font_kerning_hash( uleft, uright ) & mask;
+
+    while( self->kerning_table[i].left != UINT32_MAX )
     {
-        kerning_t * kerning = (kerning_t *) vector_get( self->kerning, i );
-        if( kerning->codepoint == ucodepoint )
+        if( self->kerning_table[i].left == uleft && self->kerning_table[i].right == uright )
         {
-            return kerning->kerning;
+            return self->kerning_table[i].kerning;
         }
+
+        i = (i + 1) & mask;
     }
+
     return 0;
 }
 
-
-// ------------------------------------------ texture_font_generate_kerning ---
-void
-texture_font_generate_kerning( texture_font_t *self)
+// ------------------------------------ texture_font_generate_glyph_kerning ---
+/*
+ * Add the kerning pairs of a new glyph with all loaded glyphs (in both
+ * directions).
+ *
+ * Addition to Freetype GL: only checks the pairs of the new glyph and
+ * nothing if the font has no kerning table.
+ */
+static void
+texture_font_generate_glyph_kerning( texture_font_t *self,
+                                     texture_glyph_t *glyph )
 {
-    size_t i, j;
-    FT_UInt glyph_index, prev_index;
-    texture_glyph_t *glyph, *prev_glyph;
+    size_t i;
+    FT_UInt glyph_index, other_index;
+    texture_glyph_t *other;
     FT_Vector kerning;
 
     assert( self );
     assert(self->library);
     assert(self->face);
 
-    /* For each glyph couple combination, check if kerning is necessary */
+    if( !self->kerning || !FT_HAS_KERNING( self->face ) || glyph->codepoint == UINT32_MAX )
+    {
+        return;
+    }
+
+    glyph_index = FT_Get_Char_Index( self->face, glyph->codepoint );
+
     /* Starts at index 1 since 0 is for the special background glyph */
     for( i=1; i<self->glyphs->size; ++i )
     {
-        glyph = *(texture_glyph_t **) vector_get( self->glyphs, i );
-        glyph_index = FT_Get_Char_Index( self->face, glyph->codepoint );
-        vector_clear( glyph->kerning );
+        other = *(texture_glyph_t **) vector_get( self->glyphs, i );
+        other_index = FT_Get_Char_Index( self->face, other->codepoint );
 
-        for( j=1; j<self->glyphs->size; ++j )
+        /* other -> glyph */
+        FT_Get_Kerning( self->face, other_index, glyph_index, FT_KERNING_UNFITTED, &kerning );
+        if( kerning.x )
         {
-            prev_glyph = *(texture_glyph_t **) vector_get( self->glyphs, j );
-            prev_index = FT_Get_Char_Index( self->face, prev_glyph->codepoint );
-            FT_Get_Kerning( self->face, prev_index, glyph_index, FT_KERNING_UNFITTED, &kerning );
-            // printf("%c(%d)-%c(%d): %ld\n",
-            //       prev_glyph->codepoint, prev_glyph->codepoint,
-            //       glyph_index, glyph_index, kerning.x);
-            if( kerning.x )
-            {
-                kerning_t k = {prev_glyph->codepoint, kerning.x / (float)(HRESf*HRESf)};
-                vector_push_back( glyph->kerning, &k );
-            }
+            texture_font_add_kerning( self, other->codepoint, glyph->codepoint, kerning.x / (float)(HRESf*HRESf) );
+        }
+
+        /* glyph -> other */
+        if( other->codepoint == glyph->codepoint )
+        {
+            continue;
         }
+
+        FT_Get_Kerning( self->face, glyph_index, other_index, FT_KERNING_UNFITTED, &kerning );
+        if( kerning.x )
+        {
+            texture_font_add_kerning( self, glyph->codepoint, other->codepoint, kerning.x / (float)(HRESf*HRESf) );
+        }
+    }
+}
+
+// ------------------------------------------ texture_font_generate_kerning ---
+void
+texture_font_generate_kerning( texture_font_t *self)
+{
+    size_t i;
+
+    assert( self );
+
+    /* Rebuild all pairs */
+    self->kerning_count = 0;
+
+    if( self->kerning_table )
+    {
+        memset( self->kerning_table, 0xff, self->kerning_table_size * sizeof(kerning_t) );
+    }
+
+    for( i=1; i<self->glyphs->size; ++i )
+    {
+        texture_font_generate_glyph_kerning( self, *(texture_glyph_t **) vector_get( self->glyphs, i ) );
     }
 }
 
@@ -445,39 +696,68 @@ texture_font_delete( texture_font_t *self )
     }
 
     vector_delete( self->glyphs );
+    free( self->glyph_table );
+    free( self->kerning_table );
     free( self );
 }
 
+// ------------------------------------------ texture_font_find_glyph_utf32 ---
 texture_glyph_t *
-texture_font_find_glyph( texture_font_t * self,
-                         const char * codepoint )
+texture_font_find_glyph_utf32( texture_font_t * self,
+                               uint32_t ucodepoint )
 {
-    size_t i;
+    size_t i, mask;
     texture_glyph_t *glyph;
-    uint32_t ucodepoint = utf8_to_utf32( codepoint );
 
-    for( i = 0; i < self->glyphs->size; ++i )
+    /* ASCII & Latin-1 */
+    if( ucodepoint < 256 )
     {
-        glyph = *(texture_glyph_t **) vector_get( self->glyphs, i );
-        // If codepoint is -1, we don't care about outline type or thickness
-        if( (glyph->codepoint == ucodepoint) &&
-            ((ucodepoint == UINT32_MAX) ||
-             ((glyph->rendermode == self->rendermode) &&
-              (glyph->outline_thickness == self->outline_thickness)) ))
+        glyph = self->latin1_glyphs[ucodepoint];
+
+        if( glyph && texture_glyph_matches( self, glyph, ucodepoint ) )
         {
             return glyph;
         }
     }
 
+    if( !self->glyph_table )
+    {
+        return NULL;
+    }
+
+    mask = self->glyph_table_size - 1;
+    i = texture_font_hash( ucodepoint ) & mask;
+
+    while( (glyph = self->glyph_table[i]) )
+    {
+        if( texture_glyph_matches( self, glyph, ucodepoint ) )
+        {
+            return glyph;
+        }
+
+        i = (i + 1) & mask;
+    }
+
     return NULL;
 }
 
-// ------------------------------------------------ texture_font_load_glyph ---
-int
-texture_font_load_glyph( texture_font_t * self,
+// ------------------------------------------------ texture_font_find_glyph ---
+texture_glyph_t *
+texture_font_find_glyph( texture_font_t * self,
                          const char * codepoint )
 {
-    size_t i, x, y;
+    return texture_font_find_glyph_utf32( self, utf8_to_utf32( codepoint ) );
+}
+
+// ---------------------------------------------- texture_font_render_glyph ---
+int
+texture_font_render_glyph( texture_font_t * self,
+                           FT_Library library,
+                           FT_Face face,
+                           uint32_t ucodepoint,
+                           texture_glyph_bitmap_t * bitmap )
+{
+    size_t i;
 
     FT_Error error;
     FT_Glyph ft_glyph;
@@ -485,52 +765,18 @@ texture_font_load_glyph( texture_font_t * self,
     FT_Bitmap ft_bitmap;
 
     FT_UInt glyph_index;
-    texture_glyph_t *glyph;
     FT_Int32 flags = 0;
     int ft_glyph_top = 0;
     int ft_glyph_left = 0;
 
-    ivec4 region;
-    //size_t missed = 0;
-
-    assert(self->library);
-    assert(self->face);
+    assert(self);
+    assert(library);
+    assert(face);
+    assert(bitmap);
 
-    /* Check if codepoint has been already loaded */
-    if (texture_font_find_glyph(self, codepoint)) {
-        return 1;
-    }
+    bitmap->buffer = NULL;
 
-    /* codepoint NULL is special : it is used for line drawing (overline,
-     * underline, strikethrough) and background.
-     */
-    if( !codepoint )
-    {
-        ivec4 region = texture_atlas_get_region( self->atlas, 5, 5 );
-        texture_glyph_t * glyph = texture_glyph_new( );
-        static unsigned char data[4*4*3] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
-                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
-        if ( region.x < 0 )
-        {
-            fprintf( stderr, "Texture atlas is full (line %d)\n",  __LINE__ );
-            return 0;
-        }
-        texture_atlas_set_region( self->atlas, region.x, region.y, 4, 4, data, 0 );
-        glyph->codepoint = -1;
-        glyph->s0 = (region.x+2)/(float)self->atlas->width;
-        glyph->t0 = (region.y+2)/(float)self->atlas->height;
-        glyph->s1 = (region.x+3)/(float)self->atlas->width;
-        glyph->t1 = (region.y+3)/(float)self->atlas->height;
-        vector_push_back( self->glyphs, &glyph );
-        return 1;
-    }
-
-    flags = 0;
-    ft_glyph_top = 0;
-    ft_glyph_left = 0;
-    glyph_index = FT_Get_Char_Index( self->face, (FT_ULong)utf8_to_utf32( codepoint ) );
+    glyph_index = FT_Get_Char_Index( face, (FT_ULong)ucodepoint );
     // WARNING: We use texture-atlas depth to guess if user wants
     //          LCD subpixel rendering
 
@@ -554,16 +800,16 @@ texture_font_load_glyph( texture_font_t * self,
 
     if( self->atlas->depth == 3 )
     {
-        FT_Library_SetLcdFilter( self->library, FT_LCD_FILTER_LIGHT );
+        FT_Library_SetLcdFilter( library, FT_LCD_FILTER_LIGHT );
         flags |= FT_LOAD_TARGET_LCD;
 
         if( self->filtering )
         {
-            FT_Library_SetLcdFilterWeights( self->library, self->lcd_weights );
+            FT_Library_SetLcdFilterWeights( library, self->lcd_weights );
         }
     }
 
-    error = FT_Load_Glyph( self->face, glyph_index, flags );
+    error = FT_Load_Glyph( face, glyph_index, flags );
     if( error )
     {
         fprintf( stderr, "FT_Error (line %d, code 0x%02x) : %s\n",
@@ -573,7 +819,7 @@ texture_font_load_glyph( texture_font_t * self,
 
     if( self->rendermode == RENDER_NORMAL || self->rendermode == RENDER_SIGNED_DISTANCE_FIELD )
     {
-        slot            = self->face->glyph;
+        slot            = face->glyph;
         ft_bitmap       = slot->bitmap;
         ft_glyph_top    = slot->bitmap_top;
         ft_glyph_left   = slot->bitmap_left;
@@ -583,7 +829,7 @@ texture_font_load_glyph( texture_font_t * self,
         FT_Stroker stroker;
         FT_BitmapGlyph ft_bitmap_glyph;
 
-        error = FT_Stroker_New( self->library, &stroker );
+        error = FT_Stroker_New( library, &stroker );
 
         if( error )
         {
@@ -598,7 +844,7 @@ texture_font_load_glyph( texture_font_t * self,
                         FT_STROKER_LINEJOIN_ROUND,
                         0);
 
-        error = FT_Get_Glyph( self->face->glyph, &ft_glyph);
+        error = FT_Get_Glyph( face->glyph, &ft_glyph);
 
         if( error )
         {
@@ -654,33 +900,28 @@ cleanup_stroker:
         int bottom;
     } padding = { 0, 0, 1, 1 };
 
-    if( self->rendermode == RENDER_SIGNED_DISTANCE_FIELD )
-    {
-        padding.top = 1;
-        padding.left = 1;
-    }
-
     //@appamics.CB: fix for vertical lines from next glyph in atlas
     padding.left = 1;
     padding.top = 1;
 
+    if( self->rendermode == RENDER_SIGNED_DISTANCE_FIELD )
+    {
+        /*
+         * Addition to Freetype GL: room for the distance falloff outside of
+         * the glyph (keeps the glyph position of the other modes).
+         */
+        padding.left = padding.top = padding.right = padding.bottom = SDF_PADDING;
+
+        ft_glyph_left -= SDF_PADDING - 1;
+        ft_glyph_top += SDF_PADDING - 1;
+    }
+
     size_t src_w = ft_bitmap.width/self->atlas->depth;
     size_t src_h = ft_bitmap.rows;
 
     size_t tgt_w = src_w + padding.left + padding.right;
     size_t tgt_h = src_h + padding.top + padding.bottom;
 
-    region = texture_atlas_get_region( self->atlas, tgt_w, tgt_h );
-
-    if ( region.x < 0 )
-    {
-        fprintf( stderr, "Texture atlas is full (line %d)\n",  __LINE__ );
-        return 0;
-    }
-
-    x = region.x;
-    y = region.y;
-
     unsigned char *buffer = calloc( tgt_w * tgt_h, sizeof(unsigned char) );
 
     //@appamics.CB: extra check
@@ -691,6 +932,9 @@ cleanup_stroker:
         memcpy( buffer + (i + padding.top) * tgt_w + padding.left, ft_bitmap.buffer + i * ft_bitmap.pitch, src_w );
     }
 
+    if( self->rendermode != RENDER_NORMAL && self->rendermode != RENDER_SIGNED_DISTANCE_FIELD )
+        FT_Done_Glyph( ft_glyph );
+
     if( self->rendermode == RENDER_SIGNED_DISTANCE_FIELD )
     {
         unsigned char *sdf = make_distance_mapb( buffer, tgt_w, tgt_h );
@@ -698,37 +942,126 @@ cleanup_stroker:
         buffer = sdf;
     }
 
-    texture_atlas_set_region( self->atlas, x, y, tgt_w, tgt_h, buffer, tgt_w );
+    bitmap->codepoint = ucodepoint;
+    bitmap->width     = tgt_w;
+    bitmap->height    = tgt_h;
+    bitmap->offset_x  = ft_glyph_left;
+    bitmap->offset_y  = ft_glyph_top;
+    bitmap->buffer    = buffer;
+
+    // Discard hinting to get advance
+    FT_Load_Glyph( face, glyph_index, FT_LOAD_RENDER | FT_LOAD_NO_HINTING);
+    slot = face->glyph;
+    bitmap->advance_x = slot->advance.x / HRESf;
+    bitmap->advance_y = slot->advance.y / HRESf;
 
-    free( buffer );
+    return 1;
+}
+
+// ------------------------------------------------ texture_font_pack_glyph ---
+int
+texture_font_pack_glyph( texture_font_t * self,
+                         const texture_glyph_bitmap_t * bitmap )
+{
+    texture_glyph_t *glyph;
+    ivec4 region;
+    texture_atlas_t *page;
+    size_t x, y;
+
+    assert(self);
+    assert(bitmap);
+    assert(bitmap->buffer);
+
+    page = texture_atlas_get_page_region( self->atlas, bitmap->width, bitmap->height, &region );
+
+    if ( !page )
+    {
+        fprintf( stderr, "Texture atlas is full (line %d)\n",  __LINE__ );
+        return 0;
+    }
+
+    x = region.x;
+    y = region.y;
+
+    texture_atlas_set_region( page, x, y, bitmap->width, bitmap->height, bitmap->buffer, bitmap->width );
 
     glyph = texture_glyph_new( );
-    glyph->codepoint = utf8_to_utf32( codepoint );
-    glyph->width    = tgt_w;
-    glyph->height   = tgt_h;
+    glyph->codepoint = bitmap->codepoint;
+    glyph->width    = bitmap->width;
+    glyph->height   = bitmap->height;
     glyph->rendermode = self->rendermode;
     glyph->outline_thickness = self->outline_thickness;
-    glyph->offset_x = ft_glyph_left;
-    glyph->offset_y = ft_glyph_top;
-    glyph->s0       = x/(float)self->atlas->width;
-    glyph->t0       = y/(float)self->atlas->height;
-    glyph->s1       = (x + glyph->width)/(float)self->atlas->width;
-    glyph->t1       = (y + glyph->height)/(float)self->atlas->height;
+    glyph->offset_x = bitmap->offset_x;
+    glyph->offset_y = bitmap->offset_y;
+    glyph->atlas    = page;
+    glyph->s0       = x/(float)page->width;
+    glyph->t0       = y/(float)page->height;
+    glyph->s1       = (x + glyph->width)/(float)page->width;
+    glyph->t1       = (y + glyph->height)/(float)page->height;
+    glyph->advance_x = bitmap->advance_x;
+    glyph->advance_y = bitmap->advance_y;
 
-    // Discard hinting to get advance
-    FT_Load_Glyph( self->face, glyph_index, FT_LOAD_RENDER | FT_LOAD_NO_HINTING);
-    slot = self->face->glyph;
-    glyph->advance_x = slot->advance.x / HRESf;
-    glyph->advance_y = slot->advance.y / HRESf;
+    texture_font_add_glyph( self, glyph );
 
-    vector_push_back( self->glyphs, &glyph );
+    texture_font_generate_glyph_kerning( self, glyph );
 
-    if( self->rendermode != RENDER_NORMAL && self->rendermode != RENDER_SIGNED_DISTANCE_FIELD )
-        FT_Done_Glyph( ft_glyph );
+    return 1;
+}
 
-    texture_font_generate_kerning( self );
+// ------------------------------------------------ texture_font_load_glyph ---
+int
+texture_font_load_glyph( texture_font_t * self,
+                         const char * codepoint )
+{
+    texture_glyph_bitmap_t bitmap;
+    int res;
 
-    return 1;
+    assert(self->library);
+    assert(self->face);
+
+    /* Check if codepoint has been already loaded */
+    if (texture_font_find_glyph(self, codepoint)) {
+        return 1;
+    }
+
+    /* codepoint NULL is special : it is used for line drawing (overline,
+     * underline, strikethrough) and background.
+     */
+    if( !codepoint )
+    {
+        ivec4 region;
+        texture_atlas_t * page = texture_atlas_get_page_region( self->atlas, 5, 5, &region );
+        texture_glyph_t * glyph;
+        static unsigned char data[4*4*3] = {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+                                            -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1};
+        if ( !page )
+        {
+            fprintf( stderr, "Texture atlas is full (line %d)\n",  __LINE__ );
+            return 0;
+        }
+        glyph = texture_glyph_new( );
+        texture_atlas_set_region( page, region.x, region.y, 4, 4, data, 0 );
+        glyph->codepoint = -1;
+        glyph->atlas = page;
+        glyph->s0 = (region.x+2)/(float)page->width;
+        glyph->t0 = (region.y+2)/(float)page->height;
+        glyph->s1 = (region.x+3)/(float)page->width;
+        glyph->t1 = (region.y+3)/(float)page->height;
+        texture_font_add_glyph( self, glyph );
+        return 1;
+    }
+
+    /* Render and pack (Addition to Freetype GL: separate steps) */
+    if( !texture_font_render_glyph( self, self->library, self->face, utf8_to_utf32( codepoint ), &bitmap ) )
+        return 0;
+
+    res = texture_font_pack_glyph( self, &bitmap );
+
+    free( bitmap.buffer );
+
+    return res;
 }
 
 // ----------------------------------------------- texture_font_load_glyphs ---
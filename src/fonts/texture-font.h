@@ -91,18 +91,22 @@ typedef enum rendermode_t
 
 
 /**
- * A structure that hold a kerning value relatively to a Unicode
- * codepoint.
+ * A structure that hold a kerning value of a pair of Unicode codepoints.
  *
- * This structure cannot be used alone since the (necessary) right
- * Unicode codepoint is implicitely held by the owner of this structure.
+ * Addition to Freetype GL: all pairs are stored in the kerning table of the
+ * font (instead of a vector per glyph).
  */
 typedef struct kerning_t
 {
     /**
      * Left Unicode codepoint in the kern pair in UTF-32 LE encoding.
      */
-    uint32_t codepoint;
+    uint32_t left;
+
+    /**
+     * Right Unicode codepoint in the kern pair in UTF-32 LE encoding.
+     */
+    uint32_t right;
 
     /**
      * Kerning value (in fractional pixels).
@@ -215,9 +219,11 @@ typedef struct texture_glyph_t
     float t1;
 
     /**
-     * A vector of kerning pairs relative to this glyph.
+     * Atlas page containing the glyph.
+     *
+     * Addition to Freetype GL.
      */
-    vector_t * kerning;
+    texture_atlas_t * atlas;
 
     /**
      * Mode this glyph was rendered
@@ -232,6 +238,45 @@ typedef struct texture_glyph_t
 } texture_glyph_t;
 
 
+/**
+ * Rendered glyph bitmap (not packed yet).
+ *
+ * Addition to Freetype GL: glyphs can be rendered on any thread and packed
+ * into the atlas later on.
+ */
+typedef struct texture_glyph_bitmap_t
+{
+    /**
+     * Unicode codepoint this glyph represents in UTF-32 LE encoding.
+     */
+    uint32_t codepoint;
+
+    /**
+     * Bitmap size in pixels (including the padding).
+     */
+    size_t width;
+    size_t height;
+
+    /**
+     * Glyph offsets.
+     */
+    int offset_x;
+    int offset_y;
+
+    /**
+     * Glyph advances.
+     */
+    float advance_x;
+    float advance_y;
+
+    /**
+     * Bitmap data (must be freed).
+     */
+    unsigned char * buffer;
+
+} texture_glyph_bitmap_t;
+
+
 
 /**
  *  Texture font structure.
@@ -243,6 +288,40 @@ typedef struct texture_font_t
      */
     vector_t * glyphs;
 
+    /**
+     * Glyph hash table (codepoint to glyph, open addressing).
+     *
+     * Addition to Freetype GL.
+     */
+    texture_glyph_t ** glyph_table;
+
+    /**
+     * Size of the glyph hash table (power of two).
+     */
+    size_t glyph_table_size;
+
+    /**
+     * Direct lookup of ASCII & Latin-1 glyphs.
+     */
+    texture_glyph_t * latin1_glyphs[256];
+
+    /**
+     * Kerning pair hash table (open addressing).
+     *
+     * Addition to Freetype GL.
+     */
+    kerning_t * kerning_table;
+
+    /**
+     * Size of the kerning hash table (power of two).
+     */
+    size_t kerning_table_size;
+
+    /**
+     * Number of kerning pairs.
+     */
+    size_t kerning_count;
+
     /**
      * Atlas structure to store glyphs data.
      */
@@ -435,6 +514,33 @@ typedef struct texture_font_t
                           const char * codepoint );
 
 
+/**
+ * Find an already loaded glyph.
+ *
+ * Addition to Freetype GL: constant time hash lookup.
+ *
+ * @param self      A valid texture font
+ * @param codepoint Character codepoint in UTF-8 encoding.
+ *
+ * @return A pointer on the glyph or 0 if it has not been loaded yet
+ */
+  texture_glyph_t *
+  texture_font_find_glyph( texture_font_t * self,
+                           const char * codepoint );
+
+/**
+ * Find an already loaded glyph.
+ *
+ * @param self       A valid texture font
+ * @param ucodepoint Character codepoint in UTF-32 encoding.
+ *
+ * @return A pointer on the glyph or 0 if it has not been loaded yet
+ */
+  texture_glyph_t *
+  texture_font_find_glyph_utf32( texture_font_t * self,
+                                 uint32_t ucodepoint );
+
+
 /**
  * Request the loading of a given glyph.
  *
@@ -461,17 +567,73 @@ typedef struct texture_font_t
   texture_font_load_glyphs( texture_font_t * self,
                             const char * codepoints );
 
+/**
+ * Open an additional face of the font.
+ *
+ * Addition to Freetype GL: FreeType objects must not be shared between
+ * threads, each thread needs its own library and face.
+ *
+ * @param self    A valid texture font
+ * @param library FreeType library of the calling thread
+ * @param face    The new face (free with FT_Done_Face())
+ *
+ * @return One if the face could be opened, zero if not.
+ */
+  int
+  texture_font_new_face( texture_font_t * self,
+                         FT_Library library,
+                         FT_Face * face );
+
+/**
+ * Render a glyph bitmap without touching the atlas.
+ *
+ * Addition to Freetype GL: may be called on any thread with its own library
+ * and face.
+ *
+ * @param self       A valid texture font
+ * @param library    FreeType library
+ * @param face       Face opened with texture_font_new_face() or self->face
+ * @param ucodepoint Character codepoint in UTF-32 encoding.
+ * @param bitmap     The rendered bitmap
+ *
+ * @return One if the glyph could be rendered, zero if not.
+ */
+  int
+  texture_font_render_glyph( texture_font_t * self,
+                             FT_Library library,
+                             FT_Face face,
+                             uint32_t ucodepoint,
+                             texture_glyph_bitmap_t * bitmap );
+
+/**
+ * Pack a rendered glyph into the atlas.
+ *
+ * Addition to Freetype GL.
+ *
+ * @param self   A valid texture font
+ * @param bitmap Glyph rendered by texture_font_render_glyph()
+ *
+ * @return One if the glyph could be packed, zero if the atlas is full.
+ */
+  int
+  texture_font_pack_glyph( texture_font_t * self,
+                           const texture_glyph_bitmap_t * bitmap );
+
 /**
  * Get the kerning between two horizontal glyphs.
  *
- * @param self      A valid texture glyph
- * @param codepoint Character codepoint of the peceding character in UTF-8 encoding.
+ * Addition to Freetype GL: replaces texture_glyph_get_kerning().
+ *
+ * @param self  A valid texture font
+ * @param left  Character codepoint of the preceding character in UTF-8 encoding.
+ * @param right Character codepoint of the current character in UTF-8 encoding.
  *
  * @return x kerning value
  */
 float
-texture_glyph_get_kerning( const texture_glyph_t * self,
-                           const char * codepoint );
+texture_font_get_kerning( const texture_font_t * self,
+                          const char * left,
+                          const char * right );
 
 
 /**
@@ -0,0 +1,291 @@
+#include "hittest.h"
+
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+#define DEBUG_HITTEST false
+
+/**
+ * Constructor.
+ */
+AminoHitIndex::AminoHitIndex() {
+    //empty
+}
+
+/**
+ * Destructor.
+ */
+AminoHitIndex::~AminoHitIndex() {
+    //empty
+}
+
+/**
+ * Remove all entries.
+ */
+void AminoHitIndex::clear() {
+    entries.clear();
+    nodeEntries.clear();
+    cellStart.clear();
+    cellItems.clear();
+
+    valid = false;
+}
+
+/**
+ * Add a rendered node.
+ *
+ * @param matrix global transform (4x4 matrix).
+ * @param clip clipping entry or -1.
+ * @param hit node can be hit.
+ * @return entry index.
+ */
+int AminoHitIndex::addNode(AminoNode *node, GLfloat *matrix, GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2, int clip, bool hit) {
+    hit_entry_t entry;
+
+    entry.node = node;
+    entry.x1 = x1;
+    entry.y1 = y1;
+    entry.x2 = x2;
+    entry.y2 = y2;
+    entry.clip = clip;
+    entry.hit = hit;
+
+    //2D affine transform (Note: z & perspective are ignored)
+    GLfloat a = matrix[0];
+    GLfloat b = matrix[1];
+    GLfloat c = matrix[4];
+    GLfloat d = matrix[5];
+    GLfloat tx = matrix[12];
+    GLfloat ty = matrix[13];
+    GLfloat det = a * d - b * c;
+
+    if (std::fabs(det) < 1e-6) {
+        //not visible (e.g. zero scale)
+        entry.hit = false;
+        entry.minX = entry.minY = 0;
+        entry.maxX = entry.maxY = -1;
+
+        entries.push_back(entry);
+        nodeEntries[node] = entries.size() - 1;
+
+        return entries.size() - 1;
+    }
+
+    //inverse
+    entry.inv[0] = d / det;
+    entry.inv[1] = -b / det;
+    entry.inv[2] = -c / det;
+    entry.inv[3] = a / det;
+    entry.inv[4] = (c * ty - d * tx) / det;
+    entry.inv[5] = (b * tx - a * ty) / det;
+
+    //screen bounds
+    GLfloat xs[4] = { x1, x2, x2, x1 };
+    GLfloat ys[4] = { y1, y1, y2, y2 };
+
+    for (int i = 0; i < 4; i++) {
+        GLfloat sx = a * xs[i] + c * ys[i] + tx;
+        GLfloat sy = b * xs[i] + d * ys[i] + ty;
+
+        if (i == 0 || sx < entry.minX) {
+            entry.minX = sx;
+        }
+
+        if (i == 0 || sx > entry.maxX) {
+            entry.maxX = sx;
+        }
+
+        if (i == 0 || sy < entry.minY) {
+            entry.minY = sy;
+        }
+
+        if (i == 0 || sy > entry.maxY) {
+            entry.maxY = sy;
+        }
+    }
+
+    //clip
+    if (clip >= 0) {
+        hit_entry_t &clipEntry = entries[clip];
+
+        entry.minX = std::max(entry.minX, clipEntry.minX);
+        entry.minY = std::max(entry.minY, clipEntry.minY);
+        entry.maxX = std::min(entry.maxX, clipEntry.maxX);
+        entry.maxY = std::min(entry.maxY, clipEntry.maxY);
+    }
+
+    entries.push_back(entry);
+    nodeEntries[node] = entries.size() - 1;
+
+    return entries.size() - 1;
+}
+
+/**
+ * Build the grid.
+ *
+ * Note: entries outside of the screen are not indexed.
+ */
+void AminoHitIndex::build(GLfloat width, GLfloat height) {
+    cols = std::max(1, (int)std::ceil(width / CELL_SIZE));
+    rows = std::max(1, (int)std::ceil(height / CELL_SIZE));
+
+    std::size_t cellCount = cols * rows;
+    std::size_t count = entries.size();
+
+    //count items per cell
+    cellStart.assign(cellCount + 1, 0);
+
+    for (std::size_t i = 0; i < count; i++) {
+        int col1, row1, col2, row2;
+
+        if (!getCellRange(entries[i], col1, row1, col2, row2)) {
+            continue;
+        }
+
+        for (int row = row1; row <= row2; row++) {
+            for (int col = col1; col <= col2; col++) {
+                cellStart[row * cols + col + 1]++;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < cellCount; i++) {
+        cellStart[i + 1] += cellStart[i];
+    }
+
+    //fill cells (rendering order)
+    std::vector<uint32_t> cellPos(cellStart.begin(), cellStart.end() - 1);
+
+    cellItems.resize(cellStart[cellCount]);
+
+    for (std::size_t i = 0; i < count; i++) {
+        int col1, row1, col2, row2;
+
+        if (!getCellRange(entries[i], col1, row1, col2, row2)) {
+            continue;
+        }
+
+        for (int row = row1; row <= row2; row++) {
+            for (int col = col1; col <= col2; col++) {
+                cellItems[cellPos[row * cols + col]++] = i;
+            }
+        }
+    }
+
+    valid = true;
+
+    if (DEBUG_HITTEST) {
+        printf("hit index: %i entries, %i cell items\n", (int)count, (int)cellItems.size());
+    }
+}
+
+/**
+ * Get the grid cells covered by an entry.
+ */
+bool AminoHitIndex::getCellRange(hit_entry_t &entry, int &col1, int &row1, int &col2, int &row2) {
+    if (!entry.hit || entry.minX > entry.maxX || entry.minY > entry.maxY) {
+        return false;
+    }
+
+    col1 = std::max(0, (int)std::floor(entry.minX / CELL_SIZE));
+    row1 = std::max(0, (int)std::floor(entry.minY / CELL_SIZE));
+    col2 = std::min(cols - 1, (int)std::floor(entry.maxX / CELL_SIZE));
+    row2 = std::min(rows - 1, (int)std::floor(entry.maxY / CELL_SIZE));
+
+    return col1 <= col2 && row1 <= row2;
+}
+
+/**
+ * Remove a node (e.g. destroyed).
+ *
+ * Note: the entry is kept as clipping area of its children.
+ */
+void AminoHitIndex::removeNode(AminoNode *node) {
+    std::unordered_map<AminoNode *, int>::iterator it = nodeEntries.find(node);
+
+    if (it == nodeEntries.end()) {
+        return;
+    }
+
+    hit_entry_t &entry = entries[it->second];
+
+    entry.node = NULL;
+    entry.hit = false;
+
+    nodeEntries.erase(it);
+}
+
+/**
+ * Check if the index was built.
+ */
+bool AminoHitIndex::isValid() {
+    return valid;
+}
+
+/**
+ * Check if a screen position is inside of the local bounds.
+ */
+bool AminoHitIndex::containsLocal(hit_entry_t &entry, GLfloat x, GLfloat y, GLfloat &localX, GLfloat &localY) {
+    if (entry.minX > entry.maxX) {
+        return false;
+    }
+
+    localX = entry.inv[0] * x + entry.inv[2] * y + entry.inv[4];
+    localY = entry.inv[1] * x + entry.inv[3] * y + entry.inv[5];
+
+    return localX >= entry.x1 && localX < entry.x2 && localY >= entry.y1 && localY < entry.y2;
+}
+
+/**
+ * Find all nodes at a screen position.
+ *
+ * Results are sorted from top to bottom.
+ */
+void AminoHitIndex::findNodes(GLfloat x, GLfloat y, std::vector<hit_result_t> &results) {
+    if (!valid || x < 0 || y < 0) {
+        return;
+    }
+
+    int col = x / CELL_SIZE;
+    int row = y / CELL_SIZE;
+
+    if (col >= cols || row >= rows) {
+        return;
+    }
+
+    //check cell items (reverse rendering order)
+    std::size_t cell = row * cols + col;
+
+    for (uint32_t i = cellStart[cell + 1]; i > cellStart[cell]; i--) {
+        hit_entry_t &entry = entries[cellItems[i - 1]];
+        hit_result_t res;
+
+        if (!entry.hit || !containsLocal(entry, x, y, res.x, res.y)) {
+            continue;
+        }
+
+        //clipping groups
+        int clip = entry.clip;
+        bool clipped = false;
+
+        while (clip >= 0) {
+            hit_entry_t &clipEntry = entries[clip];
+            GLfloat clipX, clipY;
+
+            if (!containsLocal(clipEntry, x, y, clipX, clipY)) {
+                clipped = true;
+                break;
+            }
+
+            clip = clipEntry.clip;
+        }
+
+        if (clipped) {
+            continue;
+        }
+
+        res.node = entry.node;
+        results.push_back(res);
+    }
+}
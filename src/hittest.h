@@ -0,0 +1,81 @@
+#ifndef _AMINOHITTEST_H
+#define _AMINOHITTEST_H
+
+#include "gfx.h"
+
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+class AminoNode;
+
+/**
+ * Hit test entry (one per rendered node).
+ */
+typedef struct {
+    AminoNode *node;
+
+    //screen to local transform (2D affine)
+    GLfloat inv[6];
+
+    //local bounds
+    GLfloat x1, y1, x2, y2;
+
+    //screen bounds (clipped)
+    GLfloat minX, minY, maxX, maxY;
+
+    //clipping group entry (-1 if none)
+    int clip;
+
+    //can be hit (otherwise clipping only)
+    bool hit;
+} hit_entry_t;
+
+/**
+ * Hit test result.
+ */
+typedef struct {
+    AminoNode *node;
+
+    //local position
+    GLfloat x, y;
+} hit_result_t;
+
+/**
+ * Spatial index of the rendered nodes.
+ *
+ * Uniform grid over the screen bounds. Entries are stored in rendering order.
+ *
+ * Note: not thread-safe.
+ */
+class AminoHitIndex {
+public:
+    AminoHitIndex();
+    ~AminoHitIndex();
+
+    void clear();
+    int addNode(AminoNode *node, GLfloat *matrix, GLfloat x1, GLfloat y1, GLfloat x2, GLfloat y2, int clip, bool hit);
+    void build(GLfloat width, GLfloat height);
+    bool isValid();
+    void removeNode(AminoNode *node);
+
+    void findNodes(GLfloat x, GLfloat y, std::vector<hit_result_t> &results);
+
+private:
+    static const int CELL_SIZE = 64;
+
+    std::vector<hit_entry_t> entries;
+    std::unordered_map<AminoNode *, int> nodeEntries;
+    bool valid = false;
+
+    //grid
+    int cols = 0;
+    int rows = 0;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+
+    bool getCellRange(hit_entry_t &entry, int &col1, int &row1, int &col2, int &row2);
+    bool containsLocal(hit_entry_t &entry, GLfloat x, GLfloat y, GLfloat &localX, GLfloat &localY);
+};
+
+#endif
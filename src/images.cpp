@@ -1247,6 +1247,9 @@ void AminoTexture::createVideoTexture(AsyncValueUpdate *update, int state) {
                 printf("-> init video player\n");
             }
 
+            //offline: render the frames of the player's clock
+            videoPlayer->setClockSync(true);
+
             videoPlayer->init();
         }
         uv_mutex_unlock(&videoLock);
@@ -255,7 +255,7 @@ private:
         glfwMakeContextCurrent(window);
 
         //swap interval
-        if (swapInterval != 0) {
+        if (swapInterval >= 0) {
             //debug
             //printf("swap interval: %i\n", (int)swapInterval);
 
@@ -562,6 +562,15 @@ private:
         glfwPollEvents();
     }
 
+    /**
+     * Window events have to be polled on the main thread.
+     *
+     * Note: GLFW cannot tell if events are pending without polling, the main thread is signaled every frame.
+     */
+    bool needsSystemEvents() override {
+        return true;
+    }
+
     /**
      * Update the window size.
      *
@@ -786,7 +795,7 @@ void AminoMacVideoPlayer::initDemuxer() {
     //read first frame
     double timeStart;
     READ_FRAME_RESULT res = demuxer->readRGBFrame(timeStart);
-    double timeStartSys = getTime() / 1000;
+    double timeStartSys = getClockTime();
 
     if (res == READ_END_OF_VIDEO) {
         lastError = "empty video";
@@ -803,6 +812,11 @@ void AminoMacVideoPlayer::initDemuxer() {
     //switch to renderer thread
     texture->initVideoTexture();
 
+    //live streams are not paced by the clock
+    if (demuxer->realtime) {
+        setClockSync(false);
+    }
+
     //playback loop
     while (true) {
         //check stop
@@ -814,7 +828,7 @@ void AminoMacVideoPlayer::initDemuxer() {
 
         //check pause
         if (doPause) {
-            double pauseTime = getTime() / 1000;
+            double pauseTime = getClockTime();
 
             demuxer->pause();
             handlePlaybackPaused();
@@ -829,7 +843,7 @@ void AminoMacVideoPlayer::initDemuxer() {
                 handlePlaybackResumed();
 
                 //change time
-                double resumeTime = getTime() / 1000;
+                double resumeTime = getClockTime();
 
                 timeStartSys += resumeTime - pauseTime;
             }
@@ -838,10 +852,10 @@ void AminoMacVideoPlayer::initDemuxer() {
             continue;
         }
 
-        //next frame
+        //next frame (timed by display time)
         double time;
         int res = demuxer->readRGBFrame(time);
-        double timeSys = getTime() / 1000;
+        double timeSys = getDisplayTime();
 
         if (res == READ_ERROR) {
             if (DEBUG_VIDEOS) {
@@ -873,7 +887,7 @@ void AminoMacVideoPlayer::initDemuxer() {
                 return;
             }
 
-            timeStartSys = getTime() / 1000;
+            timeStartSys = getClockTime();
             timeSys = timeStartSys;
 
             time = timeStart;
@@ -890,7 +904,7 @@ void AminoMacVideoPlayer::initDemuxer() {
             double timeSleep = (time - timeStart) - (timeSys - timeStartSys);
 
             if (timeSleep > 0) {
-                usleep(timeSleep * 1000000);
+                waitClockTime(timeSleep, doStop);
 
                 if (DEBUG_VIDEO_TIMING) {
                     printf("sleep: %f ms\n", timeSleep * 1000);
@@ -902,7 +916,7 @@ void AminoMacVideoPlayer::initDemuxer() {
         demuxer->switchRGBFrame();
 
         //update media time
-        mediaTime = getTime() / 1000 - timeStartSys;
+        mediaTime = getClockTime() - timeStartSys;
     }
 }
 
@@ -1094,6 +1108,13 @@ bool AminoMacVideoPlayer::resumePlayback() {
     return true;
 }
 
+/**
+ * Frames are switched by the playback loop (not for live streams).
+ */
+bool AminoMacVideoPlayer::isFrameSynchronous() {
+    return !demuxer || !demuxer->realtime;
+}
+
 //
 // Exit handler
 //
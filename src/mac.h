@@ -35,6 +35,7 @@ public:
     void stopPlayback() override;
     bool pausePlayback() override;
     bool resumePlayback() override;
+    bool isFrameSynchronous() override;
 
 private:
     std::string filename;
@@ -1,5 +1,8 @@
 #include "renderer.h"
 
+#include <algorithm>
+#include <cmath>
+
 #define DEBUG_RENDERER false
 #define DEBUG_RENDERER_ERRORS false
 #define DEBUG_FONT_PERFORMANCE 0
@@ -13,6 +16,8 @@ AminoRenderer::AminoRenderer(AminoGfx *gfx) {
     }
 
     this->gfx = gfx;
+
+    make_identity_matrix(identity);
 }
 
 AminoRenderer::~AminoRenderer () {
@@ -46,6 +51,13 @@ AminoRenderer::~AminoRenderer () {
         fontShader = NULL;
     }
 
+    //SDF font shader
+    if (fontSdfShader) {
+        fontSdfShader->destroy();
+        delete fontSdfShader;
+        fontSdfShader = NULL;
+    }
+
     //color lighting shader
     if (colorLightingShader) {
         colorLightingShader->destroy();
@@ -97,6 +109,12 @@ void AminoRenderer::setup() {
 
     assert(res);
 
+    //SDF font shader
+    fontSdfShader = new AminoFontSdfShader();
+    res = fontSdfShader->create();
+
+    assert(res);
+
     //context
     ctx = new GLContext();
 }
@@ -339,8 +357,15 @@ void AminoRenderer::renderScene(AminoNode *node) {
         printf("-> renderScene()\n");
     }
 
+    textDrawCount = 0;
+
     render(node);
 
+    //remaining text
+    flushText();
+
+    lastTextDrawCount = textDrawCount;
+
     ctx->reset();
 }
 
@@ -379,6 +404,13 @@ void AminoRenderer::render(AminoNode *root) {
         ctx->translate(- (root->propW->value* root->propOriginX->value), - (root->propH->value * root->propOriginY->value));
     }
 
+    //hit testing
+    int prevHitClip = hitClip;
+
+    if (hitIndex) {
+        addHitNode(root);
+    }
+
     //draw
     switch (root->type) {
         case GROUP:
@@ -386,14 +418,17 @@ void AminoRenderer::render(AminoNode *root) {
             break;
 
         case RECT:
+            flushText();
             this->drawRect(static_cast<AminoRect *>(root));
             break;
 
         case POLY:
+            flushText();
             this->drawPoly(static_cast<AminoPolygon *>(root));
             break;
 
         case MODEL:
+            flushText();
             this->drawModel(static_cast<AminoModel *>(root));
             break;
 
@@ -412,9 +447,79 @@ void AminoRenderer::render(AminoNode *root) {
     }
 
     //done
+    hitClip = prevHitClip;
     ctx->restore();
 }
 
+/**
+ * Set the hit index to fill while rendering.
+ */
+void AminoRenderer::setHitIndex(AminoHitIndex *hitIndex) {
+    this->hitIndex = hitIndex;
+    hitClip = -1;
+}
+
+/**
+ * Get the number of text draw calls of the last frame.
+ */
+uint32_t AminoRenderer::getTextDrawCount() {
+    return lastTextDrawCount;
+}
+
+/**
+ * Add a node to the hit index.
+ *
+ * Uses the current global transform.
+ */
+void AminoRenderer::addHitNode(AminoNode *node) {
+    switch (node->type) {
+        case GROUP:
+            {
+                AminoGroup *group = static_cast<AminoGroup *>(node);
+                int entry = hitIndex->addNode(node, ctx->globaltx, 0, 0, group->propW->value, group->propH->value, hitClip, true);
+
+                //clip children
+                if (group->propClipRect->value) {
+                    hitClip = entry;
+                }
+            }
+            break;
+
+        case RECT:
+            hitIndex->addNode(node, ctx->globaltx, 0, 0, node->propW->value, node->propH->value, hitClip, true);
+            break;
+
+        case POLY:
+            {
+                //geometry bounds
+                AminoPolygon *poly = static_cast<AminoPolygon *>(node);
+                float *data = poly->propGeometry->getData();
+                std::size_t count = poly->propGeometry->getLength();
+                std::size_t dim = poly->propDimension->value;
+
+                if (count < dim || dim < 2) {
+                    return;
+                }
+
+                GLfloat x1 = data[0], y1 = data[1], x2 = data[0], y2 = data[1];
+
+                for (std::size_t i = dim; i + 1 < count; i += dim) {
+                    x1 = std::min(x1, data[i]);
+                    x2 = std::max(x2, data[i]);
+                    y1 = std::min(y1, data[i + 1]);
+                    y2 = std::max(y2, data[i + 1]);
+                }
+
+                hitIndex->addNode(node, ctx->globaltx, x1, y1, x2, y2, hitClip, true);
+            }
+            break;
+
+        default:
+            //not supported (text & models)
+            break;
+    }
+}
+
 /**
  * Use solid color shader.
  */
@@ -509,6 +614,12 @@ void AminoRenderer::drawGroup(AminoGroup *group) {
     }
 
     bool useDepth = group->propDepth->value;
+    bool useClipping = group->propClipRect->value;
+
+    //text before state changes
+    if (useDepth || useClipping) {
+        flushText();
+    }
 
     if (useDepth) {
         //enable depth mask
@@ -520,8 +631,6 @@ void AminoRenderer::drawGroup(AminoGroup *group) {
      *
      *  - quite slow on Raspberry Pi!
      */
-    bool useClipping = group->propClipRect->value;
-
     if (useClipping) {
         //turn on stenciling
         glEnable(GL_STENCIL_TEST);
@@ -573,6 +682,8 @@ void AminoRenderer::drawGroup(AminoGroup *group) {
     ctx->applyOpacity(group->propOpacity->value);
 
     //render items
+    group->compactChildren();
+
     std::size_t count = group->children.size();
 
     for (std::size_t i = 0; i < count; i++) {
@@ -582,6 +693,11 @@ void AminoRenderer::drawGroup(AminoGroup *group) {
     //restore opacity
     ctx->restoreOpacity();
 
+    //text inside clip rect or depth
+    if (useDepth || useClipping) {
+        flushText();
+    }
+
     if (useClipping) {
         glDisable(GL_STENCIL_TEST);
     }
@@ -601,10 +717,9 @@ void AminoRenderer::drawPoly(AminoPolygon *poly) {
     }
 
     //vertices
-    std::vector<float> *geometry = &poly->propGeometry->value;
-    int len = geometry->size();
+    int len = poly->propGeometry->getLength();
     int dim = poly->propDimension->value;
-    GLfloat *verts = geometry->data();
+    GLfloat *verts = poly->propGeometry->getData();
 
     assert(dim == 2 || dim == 3);
 
@@ -632,15 +747,16 @@ void AminoRenderer::drawModel(AminoModel *model) {
     //check rendering mode
 
     // 1) vertices
-    std::vector<float> *vecVertices = &model->propVertices->value;
+    //Note: uploaded directly from the typed arrays
+    std::size_t vertexCount = model->propVertices->getLength();
 
-    if (vecVertices->empty()) {
+    if (vertexCount == 0) {
         return;
     }
 
     // 2) indices (optional)
-    std::vector<ushort> *vecIndices = &model->propIndices->value;
-    bool useElements = !vecIndices->empty();
+    std::size_t indexCount = model->propIndices->getLength();
+    bool useElements = indexCount > 0;
 
     if (useElements) {
         if (model->vboIndex == INVALID_BUFFER) {
@@ -652,17 +768,17 @@ void AminoRenderer::drawModel(AminoModel *model) {
 
         if (model->vboIndexModified) {
             model->vboIndexModified = false;
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort) * vecIndices->size(), vecIndices->data(), GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(ushort) * indexCount, model->propIndices->getData(), GL_STATIC_DRAW);
         }
     }
 
     // 3) normals (optional)
-    std::vector<float> *vecNormals = &model->propNormals->value;
-    bool useNormals = !vecNormals->empty();
+    std::size_t normalCount = model->propNormals->getLength();
+    bool useNormals = normalCount > 0;
 
     // 4) texture coordinates (optional)
-    std::vector<float> *vecUVs = &model->propUVs->value;
-    bool useUVs = !vecUVs->empty();
+    std::size_t uvCount = model->propUVs->getLength();
+    bool useUVs = uvCount > 0;
 
     if (useUVs && !model->propTexture->value) {
         //texture not yet loaded
@@ -679,7 +795,7 @@ void AminoRenderer::drawModel(AminoModel *model) {
         //use lighting shader
 
         if (!useElements) {
-            assert(vecNormals->size() == vecVertices->size());
+            assert(normalCount == vertexCount);
         }
 
         //get normals
@@ -692,7 +808,7 @@ void AminoRenderer::drawModel(AminoModel *model) {
 
         if (model->vboNormalModified) {
             model->vboNormalModified = false;
-            glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vecNormals->size(), vecNormals->data(), GL_STATIC_DRAW);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * normalCount, model->propNormals->getData(), GL_STATIC_DRAW);
         }
 
         //get shader
@@ -768,7 +884,7 @@ void AminoRenderer::drawModel(AminoModel *model) {
 
         if (model->vboUVModified) {
             model->vboUVModified = false;
-            glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vecUVs->size(), vecUVs->data(), GL_STATIC_DRAW);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * uvCount, model->propUVs->getData(), GL_STATIC_DRAW);
         }
 
         textureShader->setTextureCoordinates(NULL);
@@ -802,7 +918,7 @@ void AminoRenderer::drawModel(AminoModel *model) {
 
     if (model->vboVertexModified) {
         model->vboVertexModified = false;
-        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vecVertices->size(), vecVertices->data(), GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vertexCount, model->propVertices->getData(), GL_STATIC_DRAW);
     }
 
     shader->setVertexData(3, NULL);
@@ -818,10 +934,10 @@ void AminoRenderer::drawModel(AminoModel *model) {
 
     if (useElements) {
         //special case: VBO elements
-        shader->drawElements(NULL, vecIndices->size(), GL_TRIANGLES);
+        shader->drawElements(NULL, indexCount, GL_TRIANGLES);
     } else {
         //render vertices (array or VBO)
-        shader->drawTriangles(vecVertices->size() / 3, GL_TRIANGLES);
+        shader->drawTriangles(vertexCount / 3, GL_TRIANGLES);
     }
 
     //cleanup
@@ -926,10 +1042,8 @@ void AminoRenderer::drawText(AminoText *text) {
         printf("-> drawText()\n");
     }
 
-    //get texture
-    GLuint texture = text->getTextureId();
-
-    if (texture == INVALID_TEXTURE) {
+    //check glyphs
+    if (text->pages.empty()) {
         return;
     }
 
@@ -941,17 +1055,24 @@ void AminoRenderer::drawText(AminoText *text) {
     //baseline at top/left
     texture_font_t *tf = text->fontSize->fontTexture;
 
+    //SDF font: layout in base size units
+    GLfloat scale = text->fontSize->scale;
+    GLfloat ascender = tf->ascender * scale;
+    GLfloat descender = tf->descender * scale;
+    GLfloat height = tf->height * scale;
+    GLfloat lineW = text->lineW * scale;
+
     //debug
     //sprintf("font: size=%f height=%f ascender=%f descender=%f\n", tf->size, tf->height, tf->ascender, tf->descender);
 
     //horizontal alignment
     switch (text->align) {
         case AminoText::ALIGN_CENTER:
-            ctx->translate((text->propW->value - text->lineW) / 2, 0);
+            ctx->translate((text->propW->value - lineW) / 2, 0);
             break;
 
         case AminoText::ALIGN_RIGHT:
-            ctx->translate(text->propW->value - text->lineW, 0);
+            ctx->translate(text->propW->value - lineW, 0);
             break;
 
         case AminoText::ALIGN_LEFT:
@@ -962,15 +1083,15 @@ void AminoRenderer::drawText(AminoText *text) {
     //vertical alignment
     switch (text->vAlign) {
         case AminoText::VALIGN_TOP:
-            ctx->translate(0, -tf->ascender);
+            ctx->translate(0, -ascender);
             break;
 
         case AminoText::VALIGN_BOTTOM:
-            ctx->translate(0, - text->propH->value - tf->descender + (text->lineNr - 1) * tf->height);
+            ctx->translate(0, - text->propH->value - descender + (text->lineNr - 1) * height);
             break;
 
         case AminoText::VALIGN_MIDDLE:
-            ctx->translate(0, - tf->ascender - (text->propH->value - text->lineNr * tf->height) / 2);
+            ctx->translate(0, - ascender - (text->propH->value - text->lineNr * height) / 2);
             break;
 
         case AminoText::VALIGN_BASELINE:
@@ -978,34 +1099,116 @@ void AminoRenderer::drawText(AminoText *text) {
             break;
     }
 
-    //use texture
-    if (DEBUG_RENDERER_ERRORS) {
-        showGLErrors("updateTexture()");
+    //font shader
+    AminoFontShader *shader = fontShader;
+    GLfloat smoothing = 0;
+
+    if (text->fontSize->sdf) {
+        ctx->scale(scale, scale);
+
+        shader = fontSdfShader;
+
+        //screen pixels per glyph pixel (scale of x and y axes)
+        GLfloat *m = ctx->globaltx;
+        GLfloat sx = std::sqrt(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+        GLfloat sy = std::sqrt(m[4] * m[4] + m[5] * m[5] + m[6] * m[6]);
+        GLfloat pixelScale = std::max(std::sqrt(sx * sy), 0.01f);
+
+        //anti-aliased edge of about one screen pixel (distance changes by ~0.24 per glyph pixel)
+        smoothing = std::min(std::max(0.12f / pixelScale, 0.02f), 0.5f);
     }
 
-    glActiveTexture(GL_TEXTURE0);
-    ctx->bindTexture(texture);
+    //color & opacity (per vertex)
+    GLfloat color[4] = { text->propR->value, text->propG->value, text->propB->value, ctx->opacity * text->propOpacity->value };
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    //add to batch (one batch per atlas page)
+    GLfloat *m = ctx->globaltx;
 
-    //font shader
-    ctx->useShader(fontShader);
+    for (auto const &page : text->pages) {
+        std::size_t vertexCount = vector_size(page.buffer->vertices);
+        std::size_t indexCount = vector_size(page.buffer->indices);
+
+        if (page.texture.textureId == INVALID_TEXTURE || vertexCount == 0) {
+            continue;
+        }
+
+        //check batch state
+        std::size_t batchVertexCount = textBatchVertices.size() / AminoFontShader::BATCH_VERTEX_SIZE;
+
+        if (page.texture.textureId != textBatchTexture || shader != textBatchShader || smoothing != textBatchSmoothing || batchVertexCount + vertexCount > 0xFFFF) {
+            flushText();
+
+            textBatchTexture = page.texture.textureId;
+            textBatchShader = shader;
+            textBatchSmoothing = smoothing;
+            batchVertexCount = 0;
+        }
+
+        //transform vertices (x/y/z/s/t)
+        const GLfloat *vertices = (const GLfloat *)page.buffer->vertices->items;
 
-    //color & opacity
-    fontShader->setTransformation(modelView, ctx->globaltx);
-    fontShader->setOpacity(ctx->opacity * text->propOpacity->value);
+        for (std::size_t i = 0; i < vertexCount; i++) {
+            const GLfloat *v = vertices + i * 5;
+
+            textBatchVertices.push_back(m[0] * v[0] + m[4] * v[1] + m[8]  * v[2] + m[12]);
+            textBatchVertices.push_back(m[1] * v[0] + m[5] * v[1] + m[9]  * v[2] + m[13]);
+            textBatchVertices.push_back(m[2] * v[0] + m[6] * v[1] + m[10] * v[2] + m[14]);
+            textBatchVertices.push_back(v[3]);
+            textBatchVertices.push_back(v[4]);
+            textBatchVertices.insert(textBatchVertices.end(), color, color + 4);
+        }
 
-    GLfloat color[3] = { text->propR->value, text->propG->value, text->propB->value };
+        //indices
+        const GLushort *indices = (const GLushort *)page.buffer->indices->items;
+
+        for (std::size_t i = 0; i < indexCount; i++) {
+            textBatchIndices.push_back(batchVertexCount + indices[i]);
+        }
+    }
 
-    fontShader->setColor(color);
+    ctx->restore();
+}
+
+/**
+ * Render the batched text.
+ *
+ * Note: called before any other primitive is drawn (keeps the z-order).
+ */
+void AminoRenderer::flushText() {
+    if (textBatchIndices.empty()) {
+        textBatchVertices.clear();
+
+        return;
+    }
+
+    if (DEBUG_RENDERER) {
+        printf("-> flushText()\n");
+    }
 
     if (DEBUG_RENDERER_ERRORS) {
         showGLErrors("before text rendering");
     }
 
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    //font shader (vertices already transformed)
+    AminoFontShader *shader = textBatchShader;
+
+    ctx->useShader(shader);
+
+    shader->setTransformation(modelView, identity);
+
+    if (shader == fontSdfShader) {
+        fontSdfShader->setSmoothing(textBatchSmoothing);
+    }
+
     //render
-    vertex_buffer_render(text->buffer, GL_TRIANGLES);
+    ctx->bindTexture(textBatchTexture);
+    shader->setBatchData(textBatchVertices.data());
+    shader->drawElements(textBatchIndices.data(), textBatchIndices.size(), GL_TRIANGLES);
+
+    textDrawCount++;
 
     if (DEBUG_RENDERER_ERRORS) {
         showGLErrors("after text rendering");
@@ -1014,7 +1217,8 @@ void AminoRenderer::drawText(AminoText *text) {
     //cleanup
     glDisable(GL_BLEND);
 
-    ctx->restore();
+    textBatchVertices.clear();
+    textBatchIndices.clear();
 }
 
 /**
@@ -1034,6 +1238,19 @@ amino_atlas_t AminoRenderer::getAtlasTexture(texture_atlas_t *atlas, bool create
     return res;
 }
 
+/**
+ * Update texture of atlas.
+ *
+ * Returns true if data was uploaded.
+ *
+ * Note: has to be called on OpenGL thread.
+ */
+bool AminoRenderer::updateAtlasTexture(texture_atlas_t *atlas) {
+    assert(fontShader);
+
+    return fontShader->updateAtlasTexture(atlas);
+}
+
 /**
  * Output all occured OpenGL errors.
  */
@@ -278,6 +278,11 @@ public:
     virtual void renderScene(AminoNode *node);
 
     amino_atlas_t getAtlasTexture(texture_atlas_t *atlas, bool createIfMissing, bool &newTexture);
+    bool updateAtlasTexture(texture_atlas_t *atlas);
+
+    void setHitIndex(AminoHitIndex *hitIndex);
+
+    uint32_t getTextDrawCount();
 
     static int showGLErrors();
     static int showGLErrors(std::string msg);
@@ -293,11 +298,14 @@ protected:
     virtual void drawModel(AminoModel *model);
     virtual void drawText(AminoText *text);
 
+    void flushText();
+
 private:
     AminoGfx *gfx;
 
     //basic shaders
     AminoFontShader *fontShader = NULL;
+    AminoFontSdfShader *fontSdfShader = NULL;
     ColorShader *colorShader = NULL;
     TextureShader *textureShader = NULL;
     TextureClampToBorderShader *textureClampToBorderShader = NULL;
@@ -319,8 +327,26 @@ private:
 
     //matrix
     GLfloat modelView[16];
+    GLfloat identity[16];
     GLContext *ctx = NULL;
 
+    //text batch (same atlas texture and shader)
+    GLuint textBatchTexture = INVALID_TEXTURE;
+    AminoFontShader *textBatchShader = NULL;
+    GLfloat textBatchSmoothing = 0;
+    std::vector<GLfloat> textBatchVertices;
+    std::vector<GLushort> textBatchIndices;
+
+    //text draw calls (current and last frame)
+    uint32_t textDrawCount = 0;
+    uint32_t lastTextDrawCount = 0;
+
+    //hit testing
+    AminoHitIndex *hitIndex = NULL;
+    int hitClip = -1;
+
+    void addHitNode(AminoNode *node);
+
     void applyColorShader(GLfloat *verts, GLsizei dim, GLsizei count, GLfloat color[4], GLenum mode = GL_TRIANGLES);
     void applyTextureShader(GLfloat *verts, GLsizei dim, GLsizei count, GLfloat uv[][2], GLuint texId, GLfloat opacity, bool needsClampToBorder, bool repeatX, bool repeatY);
 };
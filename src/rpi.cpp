@@ -599,7 +599,7 @@ void AminoGfxRPi::initRenderer() {
     assert(EGL_FALSE != res);
 
     //swap interval
-    if (swapInterval != 0) {
+    if (swapInterval >= 0) {
         res = eglSwapInterval(display, swapInterval);
 
         assert(res == EGL_TRUE);
@@ -766,6 +766,11 @@ void AminoGfxRPi::handleSystemEvents() {
     processInputs();
 }
 
+bool AminoGfxRPi::needsSystemEvents() {
+    //input devices are polled on the main thread
+    return !fds.empty();
+}
+
 void AminoGfxRPi::processInputs() {
     if (DEBUG_GLES) {
         printf("processInputs()\n");
@@ -79,6 +79,7 @@ private:
     bool bindContext() override;
     void renderingDone() override;
     void handleSystemEvents() override;
+    bool needsSystemEvents() override;
 
     void processInputs();
     void handleEvent(input_event ev);
@@ -1822,7 +1822,7 @@ void AminoOmxVideoPlayer::initDemuxer() {
     double timeStart;
     READ_FRAME_RESULT res = demuxer->readRGBFrame(timeStart);
 
-    timeStartSys = getTime() / 1000;
+    timeStartSys = getClockTime();
 
     if (res == READ_END_OF_VIDEO) {
         lastError = "empty video";
@@ -1870,10 +1870,10 @@ void AminoOmxVideoPlayer::initDemuxer() {
             continue;
         }
 
-        //next frame
+        //next frame (timed by display time)
         double time;
         int res = demuxer->readRGBFrame(time);
-        double timeSys = getTime() / 1000;
+        double timeSys = getDisplayTime();
 
         if (res == READ_ERROR) {
             if (DEBUG_VIDEOS) {
@@ -1905,7 +1905,7 @@ void AminoOmxVideoPlayer::initDemuxer() {
                 return;
             }
 
-            timeStartSys = getTime() / 1000;
+            timeStartSys = getClockTime();
             timeSys = timeStartSys;
 
             time = timeStart;
@@ -1922,7 +1922,7 @@ void AminoOmxVideoPlayer::initDemuxer() {
             double timeSleep = (time - timeStart) - (timeSys - timeStartSys);
 
             if (timeSleep > 0) {
-                usleep(timeSleep * 1000000);
+                waitClockTime(timeSleep, doStop);
 
                 if (DEBUG_VIDEO_TIMING) {
                     printf("sleep: %f ms\n", timeSleep * 1000);
@@ -1934,6 +1934,6 @@ void AminoOmxVideoPlayer::initDemuxer() {
         demuxer->switchRGBFrame();
 
         //update media time
-        mediaTime = getTime() / 1000 - timeStartSys;
+        mediaTime = getClockTime() - timeStartSys;
     }
 }
\ No newline at end of file
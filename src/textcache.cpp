@@ -0,0 +1,153 @@
+#include "textcache.h"
+
+#include <cstdio>
+
+#define DEBUG_TEXTCACHE false
+
+/**
+ * Constructor.
+ *
+ * @param maxEntries maximum number of layouts.
+ * @param maxMemory maximum size of the vertex data (in bytes).
+ */
+AminoTextCache::AminoTextCache(std::size_t maxEntries, std::size_t maxMemory): maxEntries(maxEntries), maxMemory(maxMemory) {
+    //empty
+}
+
+/**
+ * Destructor.
+ */
+AminoTextCache::~AminoTextCache() {
+    //empty
+}
+
+/**
+ * Create the key of a layout.
+ */
+std::string AminoTextCache::createKey(texture_font_t *font, const std::string &text, int width, int wrap, int maxLines) {
+    char prefix[64];
+
+    snprintf(prefix, sizeof(prefix), "%p/%i/%i/%i/", (void *)font, width, wrap, maxLines);
+
+    return prefix + text;
+}
+
+/**
+ * Find a layout (and mark it as recently used).
+ */
+text_cache_entry_t *AminoTextCache::find(const std::string &key) {
+    auto it = index.find(key);
+
+    if (it == index.end()) {
+        misses++;
+
+        return NULL;
+    }
+
+    hits++;
+
+    //move to front
+    entries.splice(entries.begin(), entries, it->second);
+
+    return &entries.front();
+}
+
+/**
+ * Add a layout (copy).
+ */
+void AminoTextCache::store(const text_cache_entry_t &layout) {
+    auto it = index.find(layout.key);
+
+    if (it != index.end()) {
+        //replace
+        memory -= it->second->memory;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.push_front(layout);
+    index[layout.key] = entries.begin();
+
+    //memory
+    text_cache_entry_t &entry = entries.front();
+    std::size_t size = entry.key.size() + sizeof(text_cache_entry_t);
+
+    for (auto const &page : entry.pages) {
+        size += sizeof(text_cache_page_t) + page.vertices.size() * sizeof(GLfloat);
+    }
+
+    entry.memory = size;
+    memory += size;
+
+    trim();
+}
+
+/**
+ * Remove least recently used layouts.
+ */
+void AminoTextCache::trim() {
+    //Note: keeps the most recent layout
+    while (entries.size() > 1 && (entries.size() > maxEntries || memory > maxMemory)) {
+        text_cache_entry_t &entry = entries.back();
+
+        if (DEBUG_TEXTCACHE) {
+            printf("text cache: removing %s\n", entry.key.c_str());
+        }
+
+        memory -= entry.memory;
+        index.erase(entry.key);
+        entries.pop_back();
+    }
+}
+
+/**
+ * Remove all layouts of a font.
+ */
+void AminoTextCache::removeFont(texture_font_t *font) {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->font == font) {
+            memory -= it->memory;
+            index.erase(it->key);
+            it = entries.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+/**
+ * Remove all layouts.
+ */
+void AminoTextCache::clear() {
+    entries.clear();
+    index.clear();
+    memory = 0;
+}
+
+/**
+ * Get cache hits.
+ */
+uint32_t AminoTextCache::getHits() {
+    return hits;
+}
+
+/**
+ * Get cache misses.
+ */
+uint32_t AminoTextCache::getMisses() {
+    return misses;
+}
+
+/**
+ * Get number of cached layouts.
+ */
+std::size_t AminoTextCache::getEntryCount() {
+    return entries.size();
+}
+
+/**
+ * Get memory used by the cached layouts (in bytes).
+ */
+std::size_t AminoTextCache::getMemory() {
+    return memory;
+}
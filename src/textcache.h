@@ -0,0 +1,98 @@
+#ifndef _AMINOTEXTCACHE_H
+#define _AMINOTEXTCACHE_H
+
+#include "fonts.h"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Cached glyphs of a single atlas page.
+ */
+typedef struct {
+    texture_atlas_t *atlas;
+
+    //vertices (4 per glyph, x/y/z/s/t)
+    std::vector<GLfloat> vertices;
+} text_cache_page_t;
+
+/**
+ * Cached text layout.
+ */
+typedef struct {
+    std::string key;
+    texture_font_t *font;
+
+    std::vector<text_cache_page_t> pages;
+
+    //line metrics
+    int lineNr;
+    float lineW;
+
+    std::size_t memory;
+} text_cache_entry_t;
+
+class AminoText;
+class AminoFont;
+
+/**
+ * Text layout job (processed on the layout thread).
+ */
+typedef struct {
+    //node (NULL if cancelled)
+    AminoText *text;
+
+    //input
+    texture_font_t *font;
+    AminoFont *aminoFont;
+    std::string value;
+    int width;
+    int wrap;
+    int maxLines;
+
+    //result
+    text_cache_entry_t layout;
+} text_layout_job_t;
+
+/**
+ * LRU cache of text layouts (shared by all text nodes).
+ *
+ * Note: not thread-safe (guarded by the text cache mutex, locked after the font lock).
+ */
+class AminoTextCache {
+public:
+    AminoTextCache(std::size_t maxEntries, std::size_t maxMemory);
+    ~AminoTextCache();
+
+    static std::string createKey(texture_font_t *font, const std::string &text, int width, int wrap, int maxLines);
+
+    text_cache_entry_t *find(const std::string &key);
+    void store(const text_cache_entry_t &layout);
+
+    void removeFont(texture_font_t *font);
+    void clear();
+
+    uint32_t getHits();
+    uint32_t getMisses();
+    std::size_t getEntryCount();
+    std::size_t getMemory();
+
+private:
+    std::size_t maxEntries;
+    std::size_t maxMemory;
+
+    //most recently used first
+    std::list<text_cache_entry_t> entries;
+    std::unordered_map<std::string, std::list<text_cache_entry_t>::iterator> index;
+
+    std::size_t memory = 0;
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+    void trim();
+};
+
+#endif
@@ -0,0 +1,556 @@
+#include "timeline.h"
+
+#define DEBUG_TIMELINE false
+
+//
+// AminoTimeline
+//
+
+/**
+ * Constructor.
+ */
+AminoTimeline::AminoTimeline(): AminoJSObject(getFactory()->name) {
+    //empty
+}
+
+/**
+ * Destructor.
+ */
+AminoTimeline::~AminoTimeline() {
+    if (!destroyed) {
+        destroyAminoTimeline();
+    }
+}
+
+/**
+ * Handle JS constructor params.
+ */
+void AminoTimeline::preInit(Nan::NAN_METHOD_ARGS_TYPE info) {
+    assert(info.Length() == 1);
+
+    //params
+    AminoGfx *obj = Nan::ObjectWrap::Unwrap<AminoGfx>(info[0]->ToObject());
+
+    assert(obj);
+
+    //bind to queue (retains AminoGfx reference)
+    this->setEventHandler(obj);
+}
+
+/**
+ * Free all resources.
+ */
+void AminoTimeline::destroy() {
+    if (destroyed) {
+        return;
+    }
+
+    //instance
+    destroyAminoTimeline();
+
+    //base class
+    AminoJSObject::destroy();
+}
+
+/**
+ * Free instance data.
+ */
+void AminoTimeline::destroyAminoTimeline() {
+    std::size_t trackCount = trackProps.size();
+
+    for (std::size_t i = 0; i < trackCount; i++) {
+        trackProps[i]->release();
+    }
+
+    trackProps.clear();
+
+    std::size_t keyCount = keyCurves.size();
+
+    for (std::size_t i = 0; i < keyCount; i++) {
+        if (keyCurves[i]) {
+            delete keyCurves[i];
+        }
+    }
+
+    keyCurves.clear();
+
+    if (markerFunc) {
+        delete markerFunc;
+        markerFunc = NULL;
+    }
+
+    if (then) {
+        delete then;
+        then = NULL;
+    }
+}
+
+/**
+ * Create timeline factory.
+ */
+AminoTimelineFactory* AminoTimeline::getFactory() {
+    static AminoTimelineFactory *timelineFactory = NULL;
+
+    if (!timelineFactory) {
+        timelineFactory = new AminoTimelineFactory(New);
+    }
+
+    return timelineFactory;
+}
+
+/**
+ * Initialize Timeline template.
+ */
+v8::Local<v8::FunctionTemplate> AminoTimeline::GetInitFunction() {
+    v8::Local<v8::FunctionTemplate> tpl = AminoJSObject::createTemplate(getFactory());
+
+    //methods
+    Nan::SetPrototypeMethod(tpl, "_start", Start);
+    Nan::SetPrototypeMethod(tpl, "stop", Stop);
+
+    //template function
+    return tpl;
+}
+
+/**
+ * JS object construction.
+ */
+NAN_METHOD(AminoTimeline::New) {
+    AminoJSObject::createInstance(info, getFactory());
+}
+
+/**
+ * Start timeline.
+ */
+NAN_METHOD(AminoTimeline::Start) {
+    assert(info.Length() == 1);
+
+    AminoTimeline *obj = Nan::ObjectWrap::Unwrap<AminoTimeline>(info.This());
+    v8::Local<v8::Object> data = info[0]->ToObject();
+
+    assert(obj);
+
+    obj->handleStart(data);
+}
+
+/**
+ * Start timeline.
+ *
+ * Note: the rendering thread sees the timeline after all tracks were added.
+ */
+void AminoTimeline::handleStart(v8::Local<v8::Object> &data) {
+    if (started) {
+        Nan::ThrowTypeError("already started");
+        return;
+    }
+
+    if (destroyed) {
+        Nan::ThrowTypeError("timeline was stopped");
+        return;
+    }
+
+    //tracks
+    v8::Local<v8::Array> tracks = v8::Local<v8::Array>::Cast(Nan::Get(data, Nan::New<v8::String>("tracks").ToLocalChecked()).ToLocalChecked());
+    uint32_t trackCount = tracks->Length();
+
+    for (uint32_t i = 0; i < trackCount; i++) {
+        v8::Local<v8::Object> track = tracks->Get(i)->ToObject();
+
+        if (!addTrack(track)) {
+            return;
+        }
+    }
+
+    //markers
+    v8::Local<v8::Value> markersValue = Nan::Get(data, Nan::New<v8::String>("markers").ToLocalChecked()).ToLocalChecked();
+
+    if (markersValue->IsArray()) {
+        v8::Local<v8::Array> markers = v8::Local<v8::Array>::Cast(markersValue);
+        uint32_t markerCount = markers->Length();
+
+        for (uint32_t i = 0; i < markerCount; i++) {
+            markerTimes.push_back(markers->Get(i)->NumberValue());
+        }
+
+        v8::Local<v8::Value> markerLocal = Nan::Get(data, Nan::New<v8::String>("marker").ToLocalChecked()).ToLocalChecked();
+
+        if (markerLocal->IsFunction()) {
+            markerFunc = new Nan::Callback(markerLocal.As<v8::Function>());
+        }
+    }
+
+    //parameters
+    duration = Nan::Get(data, Nan::New<v8::String>("duration").ToLocalChecked()).ToLocalChecked()->NumberValue();
+    count    = Nan::Get(data, Nan::New<v8::String>("count").ToLocalChecked()).ToLocalChecked()->IntegerValue();
+
+    //then
+    v8::Local<v8::Value> thenLocal = Nan::Get(data, Nan::New<v8::String>("then").ToLocalChecked()).ToLocalChecked();
+
+    if (thenLocal->IsFunction()) {
+        then = new Nan::Callback(thenLocal.As<v8::Function>());
+    }
+
+    //refTime
+    v8::Local<v8::Value> refTimeLocal = Nan::Get(data, Nan::New<v8::String>("refTime").ToLocalChecked()).ToLocalChecked();
+
+    if (refTimeLocal->IsNumber()) {
+        hasRefTime = true;
+        refTime = refTimeLocal->NumberValue();
+    }
+
+    if (DEBUG_TIMELINE) {
+        printf("timeline: %i tracks, %i keyframes, %i markers, duration %f\n", (int)trackProps.size(), (int)keyTimes.size(), (int)markerTimes.size(), duration);
+    }
+
+    //enqueue (Note: stop() has to be called to free the instance)
+    started = true;
+
+    (static_cast<AminoGfx *>(eventHandler))->addTimeline(this);
+}
+
+/**
+ * Add a track.
+ *
+ * Track: { node, propId, times, values, easing }
+ */
+bool AminoTimeline::addTrack(v8::Local<v8::Object> &track) {
+    AminoNode *node = Nan::ObjectWrap::Unwrap<AminoNode>(Nan::Get(track, Nan::New<v8::String>("node").ToLocalChecked()).ToLocalChecked()->ToObject());
+    unsigned int propId = Nan::Get(track, Nan::New<v8::String>("propId").ToLocalChecked()).ToLocalChecked()->Uint32Value();
+
+    assert(node);
+
+    if (!node->checkRenderer(static_cast<AminoGfx *>(eventHandler))) {
+        return false;
+    }
+
+    //get property
+    AnyProperty *prop = node->getPropertyWithId(propId);
+
+    if (!prop || prop->type != PROPERTY_FLOAT) {
+        Nan::ThrowTypeError("property cannot be animated");
+        return false;
+    }
+
+    //keyframes
+    v8::Local<v8::Array> times = v8::Local<v8::Array>::Cast(Nan::Get(track, Nan::New<v8::String>("times").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> values = v8::Local<v8::Array>::Cast(Nan::Get(track, Nan::New<v8::String>("values").ToLocalChecked()).ToLocalChecked());
+    v8::Local<v8::Array> easing = v8::Local<v8::Array>::Cast(Nan::Get(track, Nan::New<v8::String>("easing").ToLocalChecked()).ToLocalChecked());
+    uint32_t keyCount = times->Length();
+
+    if (keyCount == 0 || values->Length() != keyCount || easing->Length() != keyCount) {
+        Nan::ThrowTypeError("invalid keyframes");
+        return false;
+    }
+
+    uint32_t first = keyTimes.size();
+    float prevTime = 0;
+
+    for (uint32_t i = 0; i < keyCount; i++) {
+        float time = times->Get(i)->NumberValue();
+
+        if (i > 0 && time < prevTime) {
+            Nan::ThrowTypeError("keyframes not sorted");
+            return false;
+        }
+
+        Nan::Utf8String str(easing->Get(i));
+        std::string tf = std::string(*str);
+
+        keyTimes.push_back(time);
+        keyValues.push_back(values->Get(i)->NumberValue());
+        keyEasing.push_back(AminoAnim::parseTimeFunc(tf));
+        keyCurves.push_back(i > 0 ? AminoEasing::parse(tf, time - prevTime) : NULL);
+
+        prevTime = time;
+    }
+
+    //retain property (released by destroy())
+    prop->retain();
+
+    trackProps.push_back(static_cast<FloatProperty *>(prop));
+    trackFirst.push_back(first);
+    trackLast.push_back(first + keyCount - 1);
+    trackPos.push_back(first);
+    trackState.push_back(TRACK_WAITING);
+
+    return true;
+}
+
+/**
+ * Stop and destroy timeline.
+ */
+NAN_METHOD(AminoTimeline::Stop) {
+    AminoTimeline *obj = Nan::ObjectWrap::Unwrap<AminoTimeline>(info.This());
+
+    assert(obj);
+
+    obj->stop();
+}
+
+/**
+ * Stop timeline.
+ *
+ * Note: has to be called on main thread!
+ */
+void AminoTimeline::stop() {
+    if (!destroyed) {
+        //keep instance until destroyed
+        retain();
+
+        //remove timeline
+        if (eventHandler) {
+            (static_cast<AminoGfx *>(eventHandler))->removeTimeline(this);
+        }
+
+        //free resources
+        destroy();
+
+        //release instance
+        release();
+    }
+}
+
+/**
+ * Reset all tracks to the beginning of a cycle.
+ */
+void AminoTimeline::rewind() {
+    std::size_t trackCount = trackPos.size();
+
+    for (std::size_t i = 0; i < trackCount; i++) {
+        trackPos[i] = trackFirst[i];
+        trackState[i] = TRACK_WAITING;
+    }
+
+    markerPos = 0;
+}
+
+/**
+ * Evaluate all tracks at a cycle position.
+ *
+ * Tracks are only applied between their first and last keyframe. The last value is applied once.
+ *
+ * @param t cycle time.
+ * @param notify always update the JS values (end state).
+ */
+void AminoTimeline::evaluate(float t, bool notify) {
+    std::size_t trackCount = trackProps.size();
+    const float *times = keyTimes.data();
+    const float *values = keyValues.data();
+    const uint8_t *easing = keyEasing.data();
+    AminoEasing * const *curves = keyCurves.data();
+
+    for (std::size_t i = 0; i < trackCount; i++) {
+        if (trackState[i] == TRACK_DONE) {
+            continue;
+        }
+
+        uint32_t first = trackFirst[i];
+
+        if (t < times[first]) {
+            //not started yet
+            continue;
+        }
+
+        FloatProperty *prop = trackProps[i];
+        uint32_t last = trackLast[i];
+
+        if (t >= times[last]) {
+            //end value (always sent to JS)
+            trackState[i] = TRACK_DONE;
+            prop->setValue(values[last], true);
+            continue;
+        }
+
+        trackState[i] = TRACK_RUNNING;
+
+        //find segment (time is monotonic within a cycle)
+        uint32_t pos = trackPos[i];
+
+        while (times[pos + 1] <= t) {
+            pos++;
+        }
+
+        trackPos[i] = pos;
+
+        //interpolate
+        float t0 = times[pos];
+        float v0 = values[pos];
+        float f = (t - t0) / (times[pos + 1] - t0);
+        AminoEasing *curve = curves[pos + 1];
+        float p = curve ? curve->apply(f) : AminoAnim::applyTimeFunc(easing[pos + 1], f);
+
+        prop->setValue(v0 + (values[pos + 1] - v0) * p, notify || prop->watched);
+    }
+}
+
+/**
+ * Fire all markers up to a cycle position.
+ */
+void AminoTimeline::fireMarkers(float t) {
+    std::size_t markerCount = markerTimes.size();
+
+    while (markerPos < markerCount && markerTimes[markerPos] <= t) {
+        if (markerFunc) {
+            enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoTimeline::callMarker), NULL, (void *)(uintptr_t)markerPos);
+        }
+
+        markerPos++;
+    }
+}
+
+/**
+ * Next timeline step.
+ *
+ * Note: called on rendering thread.
+ */
+void AminoTimeline::update(double currentTime) {
+    //check active
+    if (!started || ended) {
+        return;
+    }
+
+    //check remaining loops
+    if (count == 0 || duration <= 0) {
+        evaluate(duration, true);
+        fireMarkers(duration);
+        endTimeline();
+        return;
+    }
+
+    //handle first start
+    if (startTime == 0) {
+        startTime = currentTime;
+        lastTime = currentTime;
+
+        //sync with reference time
+        if (hasRefTime) {
+            if (currentTime < refTime) {
+                //in future: wait
+                startTime = 0;
+                lastTime = 0;
+                return;
+            }
+
+            startTime = refTime;
+        }
+    }
+
+    //validate time (should never happen if time is monotonic)
+    if (currentTime < lastTime) {
+        startTime = currentTime - (lastTime - startTime);
+    }
+
+    lastTime = currentTime;
+
+    //check cycle end
+    double t = currentTime - startTime;
+
+    if (t >= duration) {
+        int cycles = t / duration;
+
+        //markers of the current cycle
+        fireMarkers(duration);
+
+        if (count != FOREVER) {
+            if (cycles >= count) {
+                //end reached
+                evaluate(duration, true);
+                endTimeline();
+                return;
+            }
+
+            count -= cycles;
+        }
+
+        //next cycle
+        startTime += cycles * duration;
+        t -= cycles * duration;
+
+        rewind();
+    }
+
+    fireMarkers(t);
+    evaluate(t, false);
+}
+
+/**
+ * End the timeline.
+ */
+void AminoTimeline::endTimeline() {
+    if (ended) {
+        return;
+    }
+
+    if (DEBUG_TIMELINE) {
+        printf("Timeline: endTimeline()\n");
+    }
+
+    ended = true;
+
+    //callback function
+    if (then) {
+        //Note: not using async Nan call to keep order with stop
+        enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoTimeline::callThen), NULL, NULL);
+    }
+
+    //stop
+    enqueueJSCallbackUpdate(static_cast<jsUpdateCallback>(&AminoTimeline::callStop), NULL, NULL);
+}
+
+/**
+ * Perform marker call on main thread.
+ */
+void AminoTimeline::callMarker(JSCallbackUpdate *update) {
+    if (!markerFunc) {
+        return;
+    }
+
+    //create scope
+    Nan::HandleScope scope;
+
+    //call
+    int argc = 1;
+    v8::Local<v8::Value> argv[] = { Nan::New((uint32_t)(uintptr_t)update->data) };
+
+    Nan::Call(*markerFunc, handle(), argc, argv);
+}
+
+/**
+ * Perform then() call on main thread.
+ */
+void AminoTimeline::callThen(JSCallbackUpdate *update) {
+    if (!then) {
+        return;
+    }
+
+    //create scope
+    Nan::HandleScope scope;
+
+    //call
+    Nan::Call(*then, handle(), 0, NULL);
+}
+
+/**
+ * Perform stop() call on main thread.
+ */
+void AminoTimeline::callStop(JSCallbackUpdate *update) {
+    stop();
+}
+
+//
+// AminoTimelineFactory
+//
+
+/**
+ * Timeline factory constructor.
+ */
+AminoTimelineFactory::AminoTimelineFactory(Nan::FunctionCallback callback): AminoJSObjectFactory("AminoTimeline", callback) {
+    //empty
+}
+
+/**
+ * Create timeline instance.
+ */
+AminoJSObject* AminoTimelineFactory::create() {
+    return new AminoTimeline();
+}
@@ -0,0 +1,102 @@
+#ifndef _AMINOTIMELINE_H
+#define _AMINOTIMELINE_H
+
+#include "base.h"
+
+#include <stdint.h>
+
+class AminoTimelineFactory;
+
+/**
+ * Keyframe timeline.
+ *
+ * Animates any number of float properties. Each track has its own keyframes with an easing per segment. Sequences
+ * and parallel groups are flattened to absolute keyframe times on the JS side.
+ *
+ * Tracks and keyframes are stored as structure of arrays and evaluated in a single pass on the rendering thread.
+ */
+class AminoTimeline : public AminoJSObject {
+public:
+    AminoTimeline();
+    ~AminoTimeline();
+
+    void preInit(Nan::NAN_METHOD_ARGS_TYPE info) override;
+    void destroy() override;
+
+    //creation
+    static AminoTimelineFactory* getFactory();
+    static v8::Local<v8::FunctionTemplate> GetInitFunction();
+
+    void stop();
+    void update(double currentTime);
+
+private:
+    bool started = false;
+    bool ended = false;
+
+    //tracks
+    std::vector<FloatProperty *> trackProps;
+    std::vector<uint32_t> trackFirst;
+    std::vector<uint32_t> trackLast;
+    std::vector<uint32_t> trackPos;
+    std::vector<uint8_t> trackState;
+
+    //keyframes (absolute times)
+    std::vector<float> keyTimes;
+    std::vector<float> keyValues;
+    std::vector<uint8_t> keyEasing;
+    std::vector<AminoEasing *> keyCurves;
+
+    //markers (sorted)
+    std::vector<float> markerTimes;
+    std::size_t markerPos = 0;
+    Nan::Callback *markerFunc = NULL;
+
+    //properties
+    float duration = 0;
+    int count = 1;
+    Nan::Callback *then = NULL;
+
+    //sync time
+    double refTime = 0;
+    bool hasRefTime = false;
+
+    double startTime = 0;
+    double lastTime = 0;
+
+    static const int FOREVER = -1;
+
+    static const uint8_t TRACK_WAITING = 0;
+    static const uint8_t TRACK_RUNNING = 1;
+    static const uint8_t TRACK_DONE    = 2;
+
+    void destroyAminoTimeline();
+
+    void handleStart(v8::Local<v8::Object> &data);
+    bool addTrack(v8::Local<v8::Object> &track);
+
+    void rewind();
+    void evaluate(float t, bool notify);
+    void fireMarkers(float t);
+    void endTimeline();
+
+    void callMarker(JSCallbackUpdate *update);
+    void callThen(JSCallbackUpdate *update);
+    void callStop(JSCallbackUpdate *update);
+
+    static NAN_METHOD(New);
+    static NAN_METHOD(Start);
+    static NAN_METHOD(Stop);
+};
+
+/**
+ * Timeline factory.
+ */
+class AminoTimelineFactory : public AminoJSObjectFactory {
+public:
+    AminoTimelineFactory(Nan::FunctionCallback callback);
+
+    AminoJSObject* create() override;
+};
+
+#endif
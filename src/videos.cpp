@@ -3,6 +3,7 @@
 #include "images.h"
 
 #include <sstream>
+#include <unistd.h>
 
 #define DEBUG_VIDEO_FRAMES false
 #define DEBUG_VIDEO_STREAM false
@@ -211,6 +212,8 @@ void AminoVideoPlayer::destroy() {
  * Destroy the video player.
  */
 void AminoVideoPlayer::destroyAminoVideoPlayer() {
+    setClockSync(false);
+
     if (video) {
         video->release();
         video = NULL;
@@ -276,6 +279,9 @@ std::string AminoVideoPlayer::getState() {
  * Playback ended.
  */
 void AminoVideoPlayer::handlePlaybackDone() {
+    //no more frames
+    setClockSync(false);
+
     if (destroyed) {
         return;
     }
@@ -347,6 +353,8 @@ void AminoVideoPlayer::handlePlaybackPaused() {
         return;
     }
 
+    setClockSync(false);
+
     if (playing) {
         playing = false;
         paused = true;
@@ -371,6 +379,8 @@ void AminoVideoPlayer::handlePlaybackResumed() {
         paused = false;
         playing = true;
 
+        setClockSync(true);
+
         if (DEBUG_VIDEOS) {
             printf("video: playback resumed\n");
         }
@@ -400,6 +410,10 @@ void AminoVideoPlayer::handleInitDone(bool ready) {
     playing = ready;
     paused = false;
 
+    if (!ready) {
+        setClockSync(false);
+    }
+
     //send event
 
     //texture is ready
@@ -432,6 +446,87 @@ void AminoVideoPlayer::fireEvent(std::string event) {
     texture->fireVideoEvent(event);
 }
 
+/**
+ * Get the time a frame switched right now will be displayed (in seconds).
+ */
+double AminoVideoPlayer::getDisplayTime() {
+    AminoGfx *gfx = static_cast<AminoGfx *>(texture->getEventHandler());
+    double time = getTime();
+
+    if (gfx) {
+        time = gfx->getPresentationTime(time);
+    }
+
+    return time / 1000;
+}
+
+/**
+ * Get the clock time (in seconds).
+ *
+ * Note: virtual time in offline mode.
+ */
+double AminoVideoPlayer::getClockTime() {
+    AminoGfx *gfx = static_cast<AminoGfx *>(texture->getEventHandler());
+
+    if (gfx) {
+        return gfx->getClockTime() / 1000;
+    }
+
+    return getTime() / 1000;
+}
+
+/**
+ * Wait until the clock has advanced.
+ *
+ * @param time seconds.
+ * @param stop stop flag.
+ */
+void AminoVideoPlayer::waitClockTime(double time, bool &stop) {
+    AminoGfx *gfx = static_cast<AminoGfx *>(texture->getEventHandler());
+
+    if (!gfx || !gfx->isOffline()) {
+        usleep(time * 1000000);
+        return;
+    }
+
+    //virtual clock (advanced by the rendering thread, which waits for this frame)
+    double end = getClockTime() + time;
+
+    gfx->waitVideoClock(this, end * 1000, stop);
+}
+
+/**
+ * Check if frames are switched by the player's clock.
+ *
+ * Offline rendering waits for the frames of synchronous players.
+ */
+bool AminoVideoPlayer::isFrameSynchronous() {
+    return false;
+}
+
+/**
+ * Enable or disable the frame synchronization with the offline renderer.
+ *
+ * Note: thread-safe.
+ */
+void AminoVideoPlayer::setClockSync(bool sync) {
+    if (sync && !isFrameSynchronous()) {
+        return;
+    }
+
+    AminoGfx *gfx = static_cast<AminoGfx *>(texture->getEventHandler());
+
+    if (!gfx) {
+        return;
+    }
+
+    if (sync) {
+        gfx->addVideoSync(this);
+    } else {
+        gfx->removeVideoSync(this);
+    }
+}
+
 //
 // VideoDemuxer
 //
@@ -82,6 +82,10 @@ public:
     virtual bool pausePlayback() = 0;
     virtual bool resumePlayback() = 0;
 
+    //offline rendering
+    virtual bool isFrameSynchronous();
+    void setClockSync(bool sync);
+
 protected:
     AminoTexture *texture;
     AminoVideo *video;
@@ -114,6 +118,10 @@ protected:
     void handleRewind();
 
     void fireEvent(std::string event);
+
+    double getDisplayTime();
+    double getClockTime();
+    void waitClockTime(double time, bool &stop);
 };
 
 enum READ_FRAME_RESULT {